@@ -68,7 +68,7 @@ static inline void clock_enable_lpuart5(void)
 
 static inline void clock_enable_gpt2(void)
 {
-    CCM_CCGR2 |= (CCM_CCGR_ON << 20);
+    CCM_CCGR0 |= (CCM_CCGR_ON << 24) | (CCM_CCGR_ON << 26); // bus, serial
 }
 
 static inline void clock_enable_gpt3(void)
@@ -22,6 +22,20 @@
 #define SCB_SHPR2           (*(volatile uint32_t *)(SCB_BASE + 0x1C))
 #define SCB_SHPR3           (*(volatile uint32_t *)(SCB_BASE + 0x20))
 
+// ICSR bits
+#define SCB_ICSR_PENDSTCLR      (1UL << 25)
+#define SCB_ICSR_PENDSTSET      (1UL << 26)
+#define SCB_ICSR_PENDSVCLR      (1UL << 27)
+#define SCB_ICSR_PENDSVSET      (1UL << 28)
+
+// FPU (CPACR in SCB, FPCCR in the FP extension block)
+#define SCB_CPACR           (*(volatile uint32_t *)0xE000ED88UL)
+#define FPU_FPCCR           (*(volatile uint32_t *)0xE000EF34UL)
+
+#define SCB_CPACR_CP10_CP11     (0xFUL << 20)
+#define FPU_FPCCR_LSPEN         (1UL << 30)     // Lazy state preservation
+#define FPU_FPCCR_ASPEN         (1UL << 31)     // Auto-set CONTROL.FPCA
+
 // AIRCR bits 
 #define SCB_AIRCR_VECTKEY       (0x05FA << 16)
 #define SCB_AIRCR_SYSRESETREQ   (1 << 2)
@@ -37,6 +51,19 @@
 #define SYSTICK_CSR_TICKINT     (1 << 1)
 #define SYSTICK_CSR_CLKSOURCE   (1 << 2)
 #define SYSTICK_CSR_COUNTFLAG   (1 << 16)
+#define SYSTICK_RVR_MAX         0x00FFFFFFUL
+
+// CoreDebug / DWT (cycle counter)
+#define COREDEBUG_DEMCR     (*(volatile uint32_t *)0xE000EDFCUL)
+#define COREDEBUG_DEMCR_TRCENA  (1UL << 24)
+
+#define DWT_BASE            0xE0001000UL
+#define DWT_CTRL            (*(volatile uint32_t *)(DWT_BASE + 0x000))
+#define DWT_CYCCNT          (*(volatile uint32_t *)(DWT_BASE + 0x004))
+#define DWT_LAR             (*(volatile uint32_t *)(DWT_BASE + 0xFB0))
+
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)
+#define DWT_LAR_KEY             0xC5ACCE55UL
 
 // NVIC 
 #define NVIC_BASE           0xE000E100UL
@@ -355,6 +382,18 @@ typedef struct {
 #define GPT_CR_FO2              (1 << 30)
 #define GPT_CR_FO3              (1 << 31)
 
+// GPT Prescaler, Status and Interrupt Register bits
+#define GPT_PR_PRESCALER(n)     ((n) << 0)
+#define GPT_PR_PRESCALER24M(n)  ((n) << 12)
+#define GPT_SR_OF1              (1 << 0)
+#define GPT_SR_OF2              (1 << 1)
+#define GPT_SR_OF3              (1 << 2)
+#define GPT_SR_ROV              (1 << 5)
+#define GPT_IR_OF1IE            (1 << 0)
+#define GPT_IR_OF2IE            (1 << 1)
+#define GPT_IR_OF3IE            (1 << 2)
+#define GPT_IR_ROVIE            (1 << 5)
+
 // Watchdog (WDOG)
 
 #define WDOG1_BASE          0x400B8000UL
@@ -510,6 +549,12 @@ static inline void __set_MSP(uint32_t value) {
     __asm volatile ("msr msp, %0" :: "r" (value) : "memory");
 }
 
+static inline uint32_t __get_IPSR(void) {
+    uint32_t result;
+    __asm volatile ("mrs %0, ipsr" : "=r" (result));
+    return result;
+}
+
 static inline void __WFI(void) {
     __asm volatile ("wfi");
 }
@@ -18,7 +18,7 @@
 // Maximum number of concurrent tasks 
 #define CONFIG_MAX_TASKS                16
 
-// Maximum priority levels (0 = highest, MAX-1 = lowest) 
+// Maximum priority levels (0 = highest, MAX-1 = lowest, up to 256) 
 #define CONFIG_MAX_PRIORITY             32
 
 // Default stack size for new tasks (bytes) 
@@ -44,6 +44,39 @@
 // Enable preemption (1 = preemptive, 0 = cooperative) 
 #define CONFIG_PREEMPTIVE               1
 
+// Stop SysTick while idle and wake only for the next deadline
+#define CONFIG_TICKLESS_IDLE            0
+
+// Shortest idle stretch (in ticks) worth reprogramming SysTick for
+#define CONFIG_TICKLESS_MIN_TICKS       2
+
+// Enable earliest-deadline-first class inside one priority level
+#define CONFIG_EDF                      0
+
+// Priority level that hosts the EDF class
+#define CONFIG_EDF_PRIORITY             8
+
+// Maximum number of EDF tasks (ready heap capacity)
+#define CONFIG_EDF_MAX_TASKS            CONFIG_MAX_TASKS
+
+// Reject periodic tasks that would make the task set unschedulable
+#define CONFIG_ADMISSION_CONTROL        1
+
+// Time-partitioned scheduling over a static major frame
+#define CONFIG_PARTITIONS               0
+
+// Number of partitions, including system partition 0
+#define CONFIG_PARTITION_COUNT          4
+
+// Partition switch trace ring depth (0 = no trace)
+#define CONFIG_PARTITION_TRACE_DEPTH    16
+
+// Per-task preemption threshold and shared job stacks
+#define CONFIG_PREEMPT_THRESHOLD        0
+
+// Replace the scheduler with a table-driven cyclic executive
+#define CONFIG_CYCLIC_EXECUTIVE         0
+
 // Synchronization
 
 // Enable priority inheritance for mutexes 
@@ -52,6 +85,15 @@
 // Maximum semaphore count (0 = unlimited) 
 #define CONFIG_SEM_MAX_COUNT            0
 
+// Enable direct-to-task notifications (32-bit value in each TCB)
+#define CONFIG_TASK_NOTIFY              1
+
+// Post ISR wakeups to PendSV instead of walking wait lists in the ISR
+#define CONFIG_DEFERRED_WAKE            0
+
+// Deferred wakeup ring depth (power of two)
+#define CONFIG_DEFER_RING_DEPTH         16
+
 // Memory
 
 // Enable dynamic memory allocation (heap) 
@@ -68,19 +110,34 @@
 // Stack guard word for overflow detection 
 #define CONFIG_STACK_GUARD_WORD         0xDEADBEEF
 
+// Stack words the idle task scans per pass for high-water marks
+#define CONFIG_STACK_SCAN_WORDS         32
+
 // Enable kernel assertions 
 #define CONFIG_ASSERT                   1
 
 // Enable task runtime statistics 
 #define CONFIG_TASK_STATS               1
 
+// Per-task release lateness histogram for task_delay_until()
+#define CONFIG_JITTER_HIST              0
+
+// Histogram buckets (log2 of lateness in cycles)
+#define CONFIG_JITTER_HIST_BUCKETS      16
+
+// Enforce per-task CPU budgets measured with the DWT cycle counter
+#define CONFIG_CPU_BUDGET               0
+
+// Priority a task drops to under BUDGET_POLICY_DEMOTE
+#define CONFIG_BUDGET_DEMOTE_PRIORITY   (CONFIG_MAX_PRIORITY - 2)
+
 // Software Timers
 
 // Enable software timers 
 #define CONFIG_SW_TIMERS                1
 
-// Maximum number of software timers 
-#define CONFIG_MAX_SW_TIMERS            8
+// Run timer callbacks in a timer task instead of the SysTick ISR
+#define CONFIG_TIMER_DAEMON             1
 
 // Software timer task priority 
 #define CONFIG_TIMER_TASK_PRIORITY      1
@@ -88,6 +145,9 @@
 // Software timer task stack size 
 #define CONFIG_TIMER_STACK_SIZE         512
 
+// Microsecond one-shot timers on GPT2 output compare
+#define CONFIG_HRTIMER                  0
+
 // Event Groups
 
 // Enable event groups/flags 
@@ -118,6 +178,17 @@
 // Enable stack overflow hook 
 #define CONFIG_STACK_OVERFLOW_HOOK      1
 
+// Interrupts
+
+// Highest NVIC priority (1-15) allowed to call the kernel. Kernel critical
+// sections then raise BASEPRI to this level instead of setting PRIMASK, so
+// ISRs at a numerically lower priority are never delayed by the kernel and
+// must never call it. 0 = mask everything with PRIMASK.
+#define CONFIG_KERNEL_MAX_SYSCALL_PRIORITY  0
+
+// Route external interrupts to handler tasks (kernel/irq.h)
+#define CONFIG_THREADED_IRQ             0
+
 //ISR Stack
 
 // Separate stack for ISR handling (MSP) 
@@ -126,7 +197,9 @@
 // Assertion Macro
 
 #if CONFIG_ASSERT
+#ifndef __ASSEMBLER__
     extern void kernel_assert_failed(const char *file, int line);
+#endif
     #define KERNEL_ASSERT(expr) \
         do { if (!(expr)) kernel_assert_failed(__FILE__, __LINE__); } while(0)
 #else
@@ -18,6 +18,9 @@
 #include "../kernel/kernel.h"
 #include "../kernel/task.h"
 #include "../kernel/scheduler.h"
+#include "../kernel/partition.h"
+#include "../kernel/cyclic.h"
+#include "../kernel/irq.h"
 
 // Synchronization Primitives 
 #include "../kernel/sync/critical.h"
@@ -25,7 +28,10 @@
 #include "../kernel/sync/mutex.h"
 #include "../kernel/sync/queue.h"
 #include "../kernel/sync/event.h"
+#include "../kernel/sync/notify.h"
+#include "../kernel/sync/defer.h"
 #include "../kernel/timer.h"
+#include "../kernel/hrtimer.h"
 
 // HAL 
 #include "../hal/imxrt1062.h"
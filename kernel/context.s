@@ -2,8 +2,12 @@
  * HelixRT - Context Switch Assembly (Cortex-M7)
  *
  * PendSV:
+ * - Drain ISR-posted wakeups (CONFIG_DEFERRED_WAKE)
  * - Save outgoing task callee-saved context to PSP stack
- * - Ask scheduler for next task
+ *   (s16-s31 only when EXC_RETURN says the task has FP state)
+ * - Check the outgoing stack against its base and guard word
+ *   (CONFIG_STACK_CHECK)
+ * - Sample DWT CYCCNT and ask scheduler for next task
  * - Restore incoming task context and exception-return
  *
  * SVC:
@@ -14,6 +18,8 @@
  
  
 
+#include "../include/config.h"
+
     .syntax unified
     .cpu cortex-m7
     .fpu fpv5-d16
@@ -22,40 +28,113 @@
     .extern current_task
     .extern scheduler_select_next_task
     .extern svc_dispatch
+#if CONFIG_DEFERRED_WAKE
+    .extern defer_drain
+#endif
+#if CONFIG_STACK_CHECK
+    .extern kernel_stack_overflow
+#endif
 
     .global PendSV_Handler
     .global SVC_Handler
     .global task_start_first
 
+    .equ    DWT_CYCCNT, 0xE0001004
+    .equ    TCB_STACK_BASE, 4
+
     .text
     .align 4
 
 PendSV_Handler:
+#if CONFIG_DEFERRED_WAKE
+    // ISR-posted wakeups first, with interrupts still enabled; the
+    // outgoing task's r4-r11 are callee-saved across the call
+    push    {r0, lr}
+    bl      defer_drain
+    pop     {r0, lr}
+#endif
+
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    // Mask kernel-aware IRQs only, same as critical_enter()
+    mov     r0, #(CONFIG_KERNEL_MAX_SYSCALL_PRIORITY << 4)
+    msr     basepri, r0
+    isb
+#else
     cpsid   i
+#endif
 
     mrs     r0, psp
     ldr     r3, =current_task
     ldr     r2, [r3]
     cbz     r2, 1f
 
+    // Outgoing task used the FPU (EXC_RETURN bit 4 clear): save s16-s31.
+    // This also triggers the pending lazy save of s0-s15 into its frame.
+    tst     lr, #0x10
+    it      eq
+    vstmdbeq r0!, {s16-s31}
+
     // Save r4-r11 and EXC_RETURN (LR) for outgoing task
     stmdb   r0!, {r4-r11, lr}
     str     r0, [r2]
 
+#if CONFIG_STACK_CHECK
+    // Saved sp must stay above the base and the guard word intact
+    ldr     r1, [r2, #TCB_STACK_BASE]
+    cmp     r0, r1
+    bls     3f
+    ldr     r1, [r1]
+    ldr     r12, =CONFIG_STACK_GUARD_WORD
+    cmp     r1, r12
+    bne     3f
+#endif
+
 1:
+    // Switch timestamp for per-task cycle accounting
+    ldr     r1, =DWT_CYCCNT
+    ldr     r0, [r1]
     bl      scheduler_select_next_task
+    ldr     r3, =current_task       // r3 is not preserved across the call
     str     r0, [r3]
     cbz     r0, 2f
 
+4:
     // Restore incoming task software frame and PSP
     ldr     r1, [r0]
     ldmia   r1!, {r4-r11, lr}
+    tst     lr, #0x10
+    it      eq
+    vldmiaeq r1!, {s16-s31}
     msr     psp, r1
 
 2:
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    mov     r0, #0
+    msr     basepri, r0
+#else
     cpsie   i
+#endif
     bx      lr
 
+#if CONFIG_STACK_CHECK
+3:
+    // Overflowed: retire the task, then pick another one
+    mov     r0, r2
+    bl      kernel_stack_overflow
+    ldr     r1, =DWT_CYCCNT
+    ldr     r0, [r1]
+    bl      scheduler_select_next_task
+    ldr     r3, =current_task
+    str     r0, [r3]
+    cmp     r0, #0
+    bne     4b
+
+    // Nothing left to run: halt rather than return into the corrupt task
+5:
+    wfi
+    b       5b
+#endif
+
 SVC_Handler:
     // r0 points to stacked exception frame (MSP or PSP)
     tst     lr, #4
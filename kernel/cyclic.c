@@ -0,0 +1,127 @@
+// HelixRT - Cyclic Executive Implementation
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/config.h"
+#include "cyclic.h"
+#include "kernel.h"
+#include "timer.h"
+#include "../hal/imxrt1062.h"
+
+#if CONFIG_CYCLIC_EXECUTIVE
+
+static const cyclic_entry_t *g_entries = NULL;
+static uint32_t g_entry_count = 0;
+static uint32_t g_frame_ticks = 0;
+
+static volatile uint32_t g_tick = 0;
+static volatile uint32_t g_overruns = 0;
+
+int cyclic_set_table(const cyclic_entry_t *entries, uint32_t count,
+                     uint32_t frame_ticks)
+{
+    uint32_t i;
+
+    if (kernel_get_state() == KERNEL_STATE_RUNNING) {
+        return KERNEL_ERR_STATE;
+    }
+    if (entries == NULL || count == 0U || frame_ticks == 0U) {
+        return KERNEL_ERR_PARAM;
+    }
+    for (i = 0; i < count; i++) {
+        if (entries[i].job == NULL || entries[i].offset >= frame_ticks) {
+            return KERNEL_ERR_PARAM;
+        }
+        if (i > 0U && entries[i].offset < entries[i - 1U].offset) {
+            return KERNEL_ERR_PARAM;
+        }
+    }
+
+    g_entries = entries;
+    g_entry_count = count;
+    g_frame_ticks = frame_ticks;
+    return KERNEL_OK;
+}
+
+uint32_t cyclic_get_overruns(void)
+{
+    return g_overruns;
+}
+
+void cyclic_overrun_hook(uint32_t index, uint32_t late)
+{
+    (void)index;
+    (void)late;
+}
+
+uint32_t cyclic_get_tick(void)
+{
+    return g_tick;
+}
+
+void cyclic_run(void)
+{
+    uint32_t frame_start = 0;
+    uint32_t index = 0;
+
+    // kernel_start only gets here with a table installed
+    while (g_entries == NULL) { __WFI(); }
+
+    for (;;) {
+        const cyclic_entry_t *entry = &g_entries[index];
+        uint32_t release = frame_start + entry->offset;
+        uint32_t late;
+
+        while ((int32_t)(g_tick - release) < 0) {
+            // Masked so a tick between the check and WFI still wakes us
+            __disable_irq();
+            if ((int32_t)(g_tick - release) < 0) {
+                __WFI();
+            }
+            __enable_irq();
+        }
+
+        // Late jobs still run; the grid is kept so the frame catches up
+        late = g_tick - release;
+        if (late != 0U) {
+            g_overruns++;
+            cyclic_overrun_hook(index, late);
+        }
+
+        entry->job();
+
+        if (++index == g_entry_count) {
+            index = 0;
+            frame_start += g_frame_ticks;
+        }
+    }
+}
+
+void SysTick_Handler(void)
+{
+    kernel_time_tick();
+    g_tick++;
+#if CONFIG_SW_TIMERS
+    timer_tick_isr();
+#endif
+    kernel_tick_hook();
+}
+
+#else
+
+int cyclic_set_table(const cyclic_entry_t *entries, uint32_t count,
+                     uint32_t frame_ticks)
+{
+    (void)entries;
+    (void)count;
+    (void)frame_ticks;
+    return KERNEL_ERR_STATE;
+}
+
+uint32_t cyclic_get_overruns(void)
+{
+    return 0U;
+}
+
+#endif
@@ -0,0 +1,78 @@
+// HelixRT - Cyclic Executive API
+
+// Table-driven alternative to the preemptive scheduler. A static table
+// of (offset, job) entries is replayed every frame: jobs run to
+// completion, in table order, on the main stack, released by the tick.
+// No tasks, no PendSV switching and no per-task stacks.
+
+
+#ifndef CYCLIC_H
+#define CYCLIC_H
+
+#include <stdint.h>
+
+typedef void (*cyclic_job_t)(void);
+
+// One release in the frame
+typedef struct {
+    uint32_t offset;                // Release tick relative to frame start
+    cyclic_job_t job;               // Run-to-completion job
+} cyclic_entry_t;
+
+// Declare a schedule table in flash (entries sorted by offset)
+#define CYCLIC_TABLE_DEFINE(name, ...)                          \
+    static const cyclic_entry_t name[] = { __VA_ARGS__ }
+
+#define CYCLIC_TABLE_COUNT(name) (sizeof(name) / sizeof((name)[0]))
+
+// Cyclic Executive API
+
+/*
+ * cyclic_set_table - Install the schedule table (before kernel_start)
+ *
+ * The table is used in place and must stay valid. Offsets must be
+ * non-decreasing and below @frame_ticks; entries sharing an offset run
+ * back to back in table order.
+ *
+ * @entries:     Schedule table
+ * @count:       Number of entries
+ * @frame_ticks: Frame length in ticks
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if the
+ *          cyclic executive is not configured or already running
+ */
+
+int cyclic_set_table(const cyclic_entry_t *entries, uint32_t count,
+                     uint32_t frame_ticks);
+
+/*
+ * cyclic_get_overruns - Number of jobs released after their slot
+ */
+
+uint32_t cyclic_get_overruns(void);
+
+/*
+ * cyclic_overrun_hook - Called before a job that starts late
+ *
+ * @index: Table index of the late job
+ * @late:  Ticks past its release time
+ *
+ * Runs in the dispatch loop. Override to log or enter a safe state;
+ * the late job still runs and later slots stay on the frame grid.
+ */
+
+void cyclic_overrun_hook(uint32_t index, uint32_t late) __attribute__((weak));
+
+/*
+ * cyclic_get_tick - Ticks since kernel_start
+ */
+
+uint32_t cyclic_get_tick(void);
+
+/*
+ * cyclic_run - Dispatch loop (entered by kernel_start)
+ */
+
+void cyclic_run(void) __attribute__((noreturn));
+
+#endif // CYCLIC_H
@@ -0,0 +1,269 @@
+// HelixRT - High-Resolution Timer Implementation
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/config.h"
+#include "hrtimer.h"
+#include "kernel.h"
+#include "scheduler.h"
+#include "sync/critical.h"
+#include "../hal/imxrt1062.h"
+#include "../hal/clock.h"
+
+#if CONFIG_HRTIMER
+
+// 24 MHz crystal / 12 / 2 = 1 MHz
+#define HRTIMER_PRESCALER24M    11U
+#define HRTIMER_PRESCALER       1U
+
+// Armed timers, earliest deadline first
+static hrtimer_t *g_hr_head = NULL;
+
+// Wrap-safe: true once the counter has reached @expires
+static inline int hrtimer_due(uint32_t now, uint32_t expires)
+{
+    return (int32_t)(now - expires) >= 0;
+}
+
+// Point compare 1 at the head deadline (caller holds a critical section)
+static void hrtimer_program(void)
+{
+    if (g_hr_head == NULL) {
+        GPT2->IR &= ~GPT_IR_OF1IE;
+        return;
+    }
+
+    GPT2->OCR1 = g_hr_head->expires;
+    GPT2->SR = GPT_SR_OF1;
+    GPT2->IR |= GPT_IR_OF1IE;
+
+    // A deadline the counter passed before the write never matches
+    if (hrtimer_due(GPT2->CNT, g_hr_head->expires)) {
+        NVIC_ISPR((uint32_t)GPT2_IRQn >> 5) = 1UL << ((uint32_t)GPT2_IRQn & 31U);
+    }
+}
+
+// Caller holds a critical section
+static void hrtimer_insert(hrtimer_t *timer)
+{
+    hrtimer_t **link = &g_hr_head;
+
+    // Equal deadlines keep arming order
+    while (*link != NULL &&
+           (int32_t)((*link)->expires - timer->expires) <= 0) {
+        link = &(*link)->next;
+    }
+    timer->next = *link;
+    *link = timer;
+    timer->active = 1;
+}
+
+// Caller holds a critical section
+static void hrtimer_remove(hrtimer_t *timer)
+{
+    hrtimer_t **link = &g_hr_head;
+
+    while (*link != NULL && *link != timer) {
+        link = &(*link)->next;
+    }
+    if (*link != NULL) {
+        *link = timer->next;
+    }
+    timer->next = NULL;
+    timer->active = 0;
+}
+
+/*
+ * Overrides the weak vector in startup.c. Each expired timer is taken
+ * off the queue before its callback runs, so a callback can re-arm its
+ * own timer; the compare is reprogrammed once the head is in the future.
+ */
+void GPT2_IRQHandler(void)
+{
+    hrtimer_t *timer;
+    uint32_t irq_state;
+
+    GPT2->SR = GPT_SR_OF1;
+
+    for (;;) {
+        irq_state = critical_enter();
+        timer = g_hr_head;
+        if (timer == NULL || !hrtimer_due(GPT2->CNT, timer->expires)) {
+            hrtimer_program();
+            critical_exit(irq_state);
+            return;
+        }
+        g_hr_head = timer->next;
+        timer->next = NULL;
+        timer->active = 0;
+        critical_exit(irq_state);
+
+        timer->callback(timer->arg);
+    }
+}
+
+int hrtimer_init(void)
+{
+    clock_enable_gpt2();
+
+    GPT2->CR = 0;
+    GPT2->IR = 0;
+    GPT2->CR = GPT_CR_CLKSRC(5) | GPT_CR_EN_24M | GPT_CR_FRR |
+               GPT_CR_ENMOD | GPT_CR_WAITEN;
+    GPT2->PR = GPT_PR_PRESCALER24M(HRTIMER_PRESCALER24M) |
+               GPT_PR_PRESCALER(HRTIMER_PRESCALER);
+    GPT2->SR = GPT_SR_OF1 | GPT_SR_OF2 | GPT_SR_OF3 | GPT_SR_ROV;
+    GPT2->CR |= GPT_CR_EN;
+
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    // Callbacks call the kernel, so the vector must be maskable by BASEPRI
+    NVIC_SetPriority(GPT2_IRQn, CONFIG_KERNEL_MAX_SYSCALL_PRIORITY);
+#endif
+    NVIC_EnableIRQ(GPT2_IRQn);
+
+    return KERNEL_OK;
+}
+
+int hrtimer_create(hrtimer_t *timer, hrtimer_callback_t cb, void *arg)
+{
+    if (timer == NULL || cb == NULL) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    timer->expires = 0;
+    timer->callback = cb;
+    timer->arg = arg;
+    timer->next = NULL;
+    timer->active = 0;
+    return KERNEL_OK;
+}
+
+int hrtimer_start(hrtimer_t *timer, uint32_t delay_us)
+{
+    uint32_t irq_state;
+
+    if (timer == NULL || timer->callback == NULL ||
+        delay_us > HRTIMER_MAX_DELAY_US) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    irq_state = critical_enter();
+    if (timer->active) {
+        hrtimer_remove(timer);
+    }
+    timer->expires = GPT2->CNT + delay_us;
+    hrtimer_insert(timer);
+    if (g_hr_head == timer) {
+        hrtimer_program();
+    }
+    critical_exit(irq_state);
+
+    return KERNEL_OK;
+}
+
+int hrtimer_stop(hrtimer_t *timer)
+{
+    uint32_t irq_state;
+
+    if (timer == NULL) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    irq_state = critical_enter();
+    if (timer->active) {
+        if (g_hr_head == timer) {
+            // Retarget the compare so the head's slot does not interrupt
+            hrtimer_remove(timer);
+            hrtimer_program();
+        } else {
+            hrtimer_remove(timer);
+        }
+    }
+    critical_exit(irq_state);
+
+    return KERNEL_OK;
+}
+
+uint32_t hrtimer_now_us(void)
+{
+    return GPT2->CNT;
+}
+
+static void hrtimer_wake(void *arg)
+{
+    scheduler_unblock_task((task_tcb_t *)arg, KERNEL_OK);
+}
+
+int hrtimer_sleep_us(uint32_t us)
+{
+    hrtimer_t timer;
+    task_tcb_t *self = scheduler_get_current();
+    int res;
+
+    if (self == NULL) {
+        return KERNEL_ERR_STATE;
+    }
+
+    (void)hrtimer_create(&timer, hrtimer_wake, self);
+    res = hrtimer_start(&timer, us);
+    if (res != KERNEL_OK) {
+        return res;
+    }
+
+    // scheduler_block_on() returns at once if the timer fired already
+    res = scheduler_block_task(BLOCK_HRTIMER, &timer, TIMEOUT_FOREVER);
+
+    // The timer lives on this stack: never leave it queued
+    (void)hrtimer_stop(&timer);
+    return res;
+}
+
+#else
+
+int hrtimer_init(void)
+{
+    return KERNEL_ERR_STATE;
+}
+
+int hrtimer_create(hrtimer_t *timer, hrtimer_callback_t cb, void *arg)
+{
+    (void)timer;
+    (void)cb;
+    (void)arg;
+    return KERNEL_ERR_STATE;
+}
+
+int hrtimer_start(hrtimer_t *timer, uint32_t delay_us)
+{
+    (void)timer;
+    (void)delay_us;
+    return KERNEL_ERR_STATE;
+}
+
+int hrtimer_stop(hrtimer_t *timer)
+{
+    (void)timer;
+    return KERNEL_ERR_STATE;
+}
+
+uint32_t hrtimer_now_us(void)
+{
+    return 0;
+}
+
+int hrtimer_sleep_us(uint32_t us)
+{
+    (void)us;
+    return KERNEL_ERR_STATE;
+}
+
+#endif
+
+int hrtimer_is_active(const hrtimer_t *timer)
+{
+    if (timer == NULL) {
+        return 0;
+    }
+    return timer->active ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+// HelixRT - High-Resolution Timer API
+
+// One-shot timers with microsecond resolution, independent of the tick.
+// GPT2 free-runs at 1 MHz; armed timers sit in a deadline-sorted queue
+// and output compare 1 is programmed for the head, so the hardware
+// interrupts once per expiry instead of the kernel polling every tick.
+
+
+#ifndef HRTIMER_H
+#define HRTIMER_H
+
+#include <stdint.h>
+#include "../include/config.h"
+
+#ifndef CONFIG_HRTIMER
+#define CONFIG_HRTIMER          0
+#endif
+
+// GPT2 counter rate: one count per microsecond
+#define HRTIMER_CLOCK_HZ        1000000UL
+
+// Longest delay, so that deadlines compare correctly across counter wrap
+#define HRTIMER_MAX_DELAY_US    0x7FFFFFFFUL
+
+// Called from the GPT2 interrupt
+typedef void (*hrtimer_callback_t)(void *arg);
+
+typedef struct hrtimer {
+    uint32_t expires;               // GPT2 count at which the timer fires
+    hrtimer_callback_t callback;
+    void *arg;
+    struct hrtimer *next;           // Deadline queue link
+    volatile uint8_t active;
+} hrtimer_t;
+
+// High-Resolution Timer API
+
+/*
+ * hrtimer_init - Start GPT2 and enable its interrupt (called by kernel_init)
+ *
+ * Returns: KERNEL_OK, or KERNEL_ERR_STATE if high-resolution timers
+ *          are not configured
+ */
+
+int hrtimer_init(void);
+
+/*
+ * hrtimer_create - Initialize a timer
+ *
+ * @timer:    Timer storage (caller-owned)
+ * @cb:       Callback, run in the GPT2 interrupt
+ * @arg:      Argument for @cb
+ *
+ * Returns: KERNEL_OK or KERNEL_ERR_PARAM
+ */
+
+int hrtimer_create(hrtimer_t *timer, hrtimer_callback_t cb, void *arg);
+
+/*
+ * hrtimer_start - Arm a timer @delay_us microseconds from now
+ *
+ * Re-arms a timer that is already active. A zero delay fires as soon
+ * as the GPT2 interrupt can be taken. Callable from interrupts,
+ * including from a callback.
+ *
+ * Returns: KERNEL_OK, or KERNEL_ERR_PARAM if @delay_us exceeds
+ *          HRTIMER_MAX_DELAY_US
+ */
+
+int hrtimer_start(hrtimer_t *timer, uint32_t delay_us);
+
+/*
+ * hrtimer_stop - Disarm a timer
+ *
+ * Returns: KERNEL_OK or KERNEL_ERR_PARAM
+ */
+
+int hrtimer_stop(hrtimer_t *timer);
+
+// 1 while armed, 0 once fired or stopped
+int hrtimer_is_active(const hrtimer_t *timer);
+
+// Free-running GPT2 count in microseconds (wraps every ~71.6 minutes)
+uint32_t hrtimer_now_us(void);
+
+/*
+ * hrtimer_sleep_us - Block the calling task for @us microseconds
+ *
+ * The task is woken from the GPT2 interrupt, not the tick, so the
+ * resolution is that of the counter plus interrupt and switch latency.
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if the
+ *          caller cannot block
+ */
+
+int hrtimer_sleep_us(uint32_t us);
+
+#endif // HRTIMER_H
@@ -0,0 +1,162 @@
+// HelixRT - Threaded Interrupt Implementation
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/config.h"
+#include "irq.h"
+#include "kernel.h"
+#include "sync/notify.h"
+#include "sync/critical.h"
+#include "../hal/imxrt1062.h"
+
+#if CONFIG_THREADED_IRQ
+
+// Routing table, indexed by external interrupt number
+static irq_thread_t *g_irq_table[IRQ_LINE_COUNT];
+static volatile uint32_t g_spurious = 0;
+
+static void irq_thread_entry(void *arg)
+{
+    irq_thread_t *it = (irq_thread_t *)arg;
+    uint32_t lat;
+
+    for (;;) {
+        if (task_notify_wait(0, 0, NULL, TIMEOUT_FOREVER) != KERNEL_OK) {
+            continue;
+        }
+
+        // The line is masked until we unmask it, so the stamp is stable
+        lat = DWT_CYCCNT - it->stamp;
+        it->lat_last = lat;
+        if (it->count == 0U || lat < it->lat_min) {
+            it->lat_min = lat;
+        }
+        if (lat > it->lat_max) {
+            it->lat_max = lat;
+        }
+        it->count++;
+
+        it->thread(it->irq, it->arg);
+        NVIC_EnableIRQ((IRQn_Type)it->irq);
+    }
+}
+
+/*
+ * Every external interrupt in the vector table lands here (overrides
+ * the weak spin loop in startup.c). Kept to a table lookup, a mask and
+ * a notification; the top half is the only driver code in handler mode.
+ */
+void Default_Handler(void)
+{
+    uint32_t irq = (__get_IPSR() & 0x1FFU) - 16U;
+    irq_thread_t *it;
+
+    if (irq >= IRQ_LINE_COUNT) {
+        return;
+    }
+
+    NVIC_DisableIRQ((IRQn_Type)irq);
+    it = g_irq_table[irq];
+    if (it == NULL) {
+        g_spurious++;
+        return;
+    }
+
+    it->stamp = DWT_CYCCNT;
+    if (it->top != NULL && !it->top(irq, it->arg)) {
+        NVIC_EnableIRQ((IRQn_Type)irq);
+        return;
+    }
+
+    task_notify_isr(&it->tcb, 0, NOTIFY_NONE);
+}
+
+int irq_request_threaded(irq_thread_t *it,
+                         uint32_t irq,
+                         irq_top_half_t top,
+                         irq_thread_fn_t thread,
+                         void *arg,
+                         uint8_t priority,
+                         uint32_t *stack,
+                         uint32_t stack_size)
+{
+    uint32_t irq_state;
+    int res;
+
+    if (it == NULL || thread == NULL || irq >= IRQ_LINE_COUNT) {
+        return KERNEL_ERR_PARAM;
+    }
+    if (g_irq_table[irq] != NULL) {
+        return KERNEL_ERR_STATE;
+    }
+
+    it->top = top;
+    it->thread = thread;
+    it->arg = arg;
+    it->irq = irq;
+    it->stamp = 0;
+    it->count = 0;
+    it->lat_last = 0;
+    it->lat_min = 0;
+    it->lat_max = 0;
+
+    res = task_create(&it->tcb, "irq", irq_thread_entry, it, priority,
+                      stack, stack_size);
+    if (res != KERNEL_OK) {
+        return res;
+    }
+
+    irq_state = critical_enter();
+    if (g_irq_table[irq] != NULL) {
+        critical_exit(irq_state);
+        task_delete(&it->tcb);
+        return KERNEL_ERR_STATE;
+    }
+    g_irq_table[irq] = it;
+    critical_exit(irq_state);
+
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    // The vector calls the kernel, so it must be maskable by BASEPRI
+    if ((NVIC_IPR(irq) >> 4) < CONFIG_KERNEL_MAX_SYSCALL_PRIORITY) {
+        NVIC_SetPriority((IRQn_Type)irq, CONFIG_KERNEL_MAX_SYSCALL_PRIORITY);
+    }
+#endif
+    NVIC_EnableIRQ((IRQn_Type)irq);
+
+    return KERNEL_OK;
+}
+
+uint32_t irq_get_spurious(void)
+{
+    return g_spurious;
+}
+
+#else
+
+int irq_request_threaded(irq_thread_t *it,
+                         uint32_t irq,
+                         irq_top_half_t top,
+                         irq_thread_fn_t thread,
+                         void *arg,
+                         uint8_t priority,
+                         uint32_t *stack,
+                         uint32_t stack_size)
+{
+    (void)it;
+    (void)irq;
+    (void)top;
+    (void)thread;
+    (void)arg;
+    (void)priority;
+    (void)stack;
+    (void)stack_size;
+    return KERNEL_ERR_STATE;
+}
+
+uint32_t irq_get_spurious(void)
+{
+    return 0;
+}
+
+#endif
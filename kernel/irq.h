@@ -0,0 +1,93 @@
+// HelixRT - Threaded Interrupt API
+
+// Driver work runs in a handler task at a kernel priority instead of in
+// handler mode. The vector only masks the line, runs an optional short
+// top half that acknowledges the device and notifies the task; the
+// scheduler then arbitrates driver work against application tasks.
+
+
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../include/config.h"
+#include "task.h"
+
+#ifndef CONFIG_THREADED_IRQ
+#define CONFIG_THREADED_IRQ     0
+#endif
+
+#if CONFIG_THREADED_IRQ && !CONFIG_TASK_NOTIFY
+#error "CONFIG_THREADED_IRQ needs CONFIG_TASK_NOTIFY (handler tasks are woken by notification)"
+#endif
+
+// External interrupt lines on the IMXRT1062
+#define IRQ_LINE_COUNT          160
+
+/*
+ * Top half, called in handler mode with the line already masked.
+ * Acknowledges the device; returns false if the interrupt needs no
+ * thread work (the line is unmasked again immediately).
+ */
+typedef bool (*irq_top_half_t)(uint32_t irq, void *arg);
+
+// Thread handler, called in the handler task once per wakeup
+typedef void (*irq_thread_fn_t)(uint32_t irq, void *arg);
+
+// One threaded interrupt (TCB included, stack supplied by the caller)
+typedef struct {
+    task_tcb_t tcb;                 // Handler task
+    irq_top_half_t top;
+    irq_thread_fn_t thread;
+    void *arg;
+    uint32_t irq;
+    volatile uint32_t stamp;        // DWT CYCCNT at the last vector entry
+    uint32_t count;                 // Thread handler runs
+    uint32_t lat_last;              // Vector entry to thread handler, cycles
+    uint32_t lat_min;
+    uint32_t lat_max;
+} irq_thread_t;
+
+// Threaded Interrupt API
+
+/*
+ * irq_request_threaded - Route an interrupt line to a handler task
+ *
+ * Creates the handler task at @priority and enables the line. The line
+ * stays masked from vector entry until @thread returns, so a device
+ * that is not acknowledged by @top cannot storm the CPU. In BASEPRI
+ * mode the NVIC priority is lowered to CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+ * if needed, since the vector calls the kernel.
+ *
+ * @it:         Threaded interrupt storage (static)
+ * @irq:        External interrupt number (< IRQ_LINE_COUNT)
+ * @top:        Top half (NULL = none, always wake the task)
+ * @thread:     Thread handler
+ * @arg:        Argument for @top and @thread
+ * @priority:   Handler task priority (0 = highest)
+ * @stack:      Handler task stack
+ * @stack_size: Stack size in bytes
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if the line
+ *          is already routed or threaded interrupts are not configured
+ */
+
+int irq_request_threaded(irq_thread_t *it,
+                         uint32_t irq,
+                         irq_top_half_t top,
+                         irq_thread_fn_t thread,
+                         void *arg,
+                         uint8_t priority,
+                         uint32_t *stack,
+                         uint32_t stack_size);
+
+/*
+ * irq_get_spurious - Interrupts taken on lines with no handler
+ *
+ * Such a line is disabled in the NVIC on its first interrupt.
+ */
+
+uint32_t irq_get_spurious(void);
+
+#endif // IRQ_H
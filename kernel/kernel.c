@@ -14,7 +14,11 @@
 #include "kernel.h"
 #include "scheduler.h"
 #include "sync/critical.h"
+#include "sync/mutex.h"
 #include "syscall.h"
+#include "timer.h"
+#include "hrtimer.h"
+#include "cyclic.h"
 #include "../hal/imxrt1062.h"
 
 // Exposed for HAL/clock users   
@@ -32,13 +36,53 @@ static uint32_t g_stack_pool[CONFIG_MAX_TASKS][CONFIG_DEFAULT_STACK_SIZE / sizeo
 static uint8_t g_stack_slot_used[CONFIG_MAX_TASKS];
 static uint32_t g_next_task_id = 1;
 
+#if !CONFIG_CYCLIC_EXECUTIVE
 // Idle task is always present to keep scheduler runnable
 static task_tcb_t g_idle_tcb;
 static uint32_t g_idle_stack[CONFIG_IDLE_STACK_SIZE / sizeof(uint32_t)]
     __attribute__((section(".task_stacks"), aligned(8)));
+#endif
 
 static void task_exit_trampoline(void);
+static void periodic_job_entry(void *arg);
+#if CONFIG_PREEMPT_THRESHOLD
+static void shared_job_entry(void *arg);
+#endif
+#if !CONFIG_CYCLIC_EXECUTIVE
 static void idle_task(void *arg);
+#endif
+static void time_init(void);
+
+// context.s loads stack_base at a fixed offset for the overflow check
+_Static_assert(offsetof(task_tcb_t, stack_base) == 4, "stack_base must stay at TCB offset 4");
+
+/*
+ * Time base: a 64-bit epoch in cycles and nanoseconds, anchored at a
+ * CYCCNT value. The tick writes the next epoch into the idle slot and
+ * then flips g_time_gen, so a reader never sees a half-written epoch,
+ * even from an interrupt that preempts the tick. Re-anchoring every
+ * tick keeps the CYCCNT delta far from its 2^32 wrap (7.1 s at 600 MHz).
+ */
+typedef struct {
+    uint64_t cycles;
+    uint64_t ns;
+    uint32_t ns_frac;               // Sub-ns remainder, in 2^-g_time_shift ns
+    uint32_t anchor;                // CYCCNT at this epoch
+} time_epoch_t;
+
+static time_epoch_t g_time_epoch[2];
+static volatile uint32_t g_time_gen = 0;
+
+// ns per cycle as a 32-bit fixed-point multiplier: ns = (cycles * mult) >> shift
+static uint32_t g_time_mult = 0;
+static uint32_t g_time_shift = 0;
+
+#if CONFIG_STACK_CHECK && CONFIG_TASK_STATS && !CONFIG_CYCLIC_EXECUTIVE
+// Every created task, for the idle-time high-water scan
+static task_tcb_t *g_task_list = NULL;
+static task_tcb_t *g_scan_task = NULL;
+static uint32_t g_scan_word = 0;
+#endif
 
 static int alloc_slot(uint8_t *bitmap, uint32_t count)
 {
@@ -73,16 +117,229 @@ static void copy_task_name(char *dst, const char *src)
     dst[i] = '\0';
 }
 
+/*
+ * Admission table: timing parameters of every live periodic task as
+ * they were admitted. Kept separate from the TCBs so a candidate can be
+ * tested against the set before it is scheduled.
+ */
+typedef struct {
+    task_tcb_t *tcb;
+    uint32_t period;
+    uint32_t deadline;
+    uint32_t wcet;
+    uint8_t priority;
+} periodic_entry_t;
+
+static periodic_entry_t g_periodic[CONFIG_MAX_TASKS];
+static uint32_t g_periodic_count = 0;
+
+#if CONFIG_ADMISSION_CONTROL
+#if CONFIG_EDF
+/*
+ * Job density C/D in 1/65536 units, rounded up. Long division eight
+ * fraction bits at a time: the remainder stays below the deadline, at
+ * most PERIODIC_MAX_TICKS, so shifting it by 8 cannot overflow.
+ */
+static uint32_t density_q16(uint32_t wcet, uint32_t deadline)
+{
+    uint32_t rem, hi, lo;
+
+    if (wcet >= deadline) {
+        return 0x10000U;
+    }
+    rem = wcet << 8;
+    hi = rem / deadline;
+    rem = (rem % deadline) << 8;
+    lo = rem / deadline;
+    if (rem % deadline != 0U) {
+        lo++;
+    }
+    return (hi << 8) + lo;
+}
+
+/*
+ * EDF: periodic tasks all share the EDF level, and the set is feasible
+ * if total density sum(C/D) does not exceed one (exact for D == T).
+ */
+static bool periodic_set_feasible(uint32_t count)
+{
+    uint32_t total = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        total += density_q16(g_periodic[i].wcet, g_periodic[i].deadline);
+        if (total > 0x10000U) {
+            return false;
+        }
+    }
+    return true;
+}
+#else
+/*
+ * Fixed priority: response-time analysis. Each task's worst-case
+ * response R = C + sum(ceil(R / Tj) * Cj) over tasks of equal or
+ * higher priority must converge within its deadline.
+ */
+static bool periodic_set_feasible(uint32_t count)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < count; i++) {
+        const periodic_entry_t *ti = &g_periodic[i];
+        uint32_t prev;
+        uint32_t resp = ti->wcet;
+
+        do {
+            prev = resp;
+            resp = ti->wcet;
+            for (j = 0; j < count; j++) {
+                const periodic_entry_t *tj = &g_periodic[j];
+                if (j != i && tj->priority <= ti->priority) {
+                    resp += ((prev + tj->period - 1U) / tj->period) * tj->wcet;
+                }
+                // Checked per term: each adds at most 2 * PERIODIC_MAX_TICKS
+                if (resp > ti->deadline) {
+                    return false;
+                }
+            }
+        } while (resp != prev);
+    }
+    return true;
+}
+#endif
+#endif
+
+// Add a candidate to the admission table if the set stays schedulable
+static bool periodic_admit(task_tcb_t *tcb, uint8_t priority,
+                           uint32_t period, uint32_t deadline, uint32_t wcet)
+{
+    periodic_entry_t *entry;
+
+    if (g_periodic_count >= CONFIG_MAX_TASKS) {
+        return false;
+    }
+
+    entry = &g_periodic[g_periodic_count];
+    entry->tcb = tcb;
+    entry->period = period;
+    entry->deadline = deadline;
+    entry->wcet = wcet;
+    entry->priority = priority;
+
+#if CONFIG_ADMISSION_CONTROL
+    if (!periodic_set_feasible(g_periodic_count + 1U)) {
+        return false;
+    }
+#endif
+
+    g_periodic_count++;
+    return true;
+}
+
+// Re-run admission with a periodic task at a new priority; false keeps the old one
+static bool periodic_reprioritize(task_tcb_t *tcb, uint8_t priority)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_periodic_count; i++) {
+        if (g_periodic[i].tcb == tcb) {
+#if CONFIG_ADMISSION_CONTROL
+            uint8_t old = g_periodic[i].priority;
+
+            g_periodic[i].priority = priority;
+            if (!periodic_set_feasible(g_periodic_count)) {
+                g_periodic[i].priority = old;
+                return false;
+            }
+#else
+            g_periodic[i].priority = priority;
+#endif
+            return true;
+        }
+    }
+    return true;
+}
+
+// Admission table entry of @tcb, NULL if it is not a periodic task
+static periodic_entry_t *periodic_find(task_tcb_t *tcb)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_periodic_count; i++) {
+        if (g_periodic[i].tcb == tcb) {
+            return &g_periodic[i];
+        }
+    }
+    return NULL;
+}
+
+// Re-run admission with a periodic task on new timing; false keeps the old one
+static bool periodic_retime(periodic_entry_t *entry, uint32_t period, uint32_t deadline)
+{
+#if CONFIG_ADMISSION_CONTROL
+    periodic_entry_t old = *entry;
+
+    entry->period = period;
+    entry->deadline = deadline;
+    if (!periodic_set_feasible(g_periodic_count)) {
+        *entry = old;
+        return false;
+    }
+#else
+    entry->period = period;
+    entry->deadline = deadline;
+#endif
+    return true;
+}
+
+static void periodic_withdraw(task_tcb_t *tcb)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_periodic_count; i++) {
+        if (g_periodic[i].tcb == tcb) {
+            g_periodic_count--;
+            g_periodic[i] = g_periodic[g_periodic_count];
+            return;
+        }
+    }
+}
+
 int kernel_init(void)
 {
     if (g_kernel_state != KERNEL_STATE_UNINIT) {
         return KERNEL_ERR_STATE;
     }
 
+    // Free-running cycle counter: time base, CPU accounting, partition trace
+    COREDEBUG_DEMCR |= COREDEBUG_DEMCR_TRCENA;
+    DWT_LAR = DWT_LAR_KEY;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+    time_init();
+
+#if CONFIG_HRTIMER
+    // GPT2 runs in both modes; callbacks do not need a task
+    if (hrtimer_init() != KERNEL_OK) {
+        return KERNEL_ERR_STATE;
+    }
+#endif
+
+#if CONFIG_CYCLIC_EXECUTIVE
+    // No tasks: the idle task, PendSV and ready/blocked lists are unused
+    SCB_SHPR3 = (SCB_SHPR3 & 0x00FFFFFFUL) | (0xFEUL << 24);
+    g_kernel_state = KERNEL_STATE_INIT;
+    return KERNEL_OK;
+#else
     scheduler_init();
 
     // PendSV lowest, SysTick just above it for deterministic preemption
     SCB_SHPR3 = (SCB_SHPR3 & 0x0000FFFFUL) | (0xFFUL << 16) | (0xFEUL << 24);
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    // SVCall runs kernel code: keep it below the zero-latency IRQs
+    SCB_SHPR2 = (SCB_SHPR2 & 0x00FFFFFFUL) |
+                ((uint32_t)CONFIG_KERNEL_MAX_SYSCALL_PRIORITY << 28);
+#endif
 
     if (task_create(&g_idle_tcb,
                     "idle",
@@ -94,8 +351,14 @@ int kernel_init(void)
         return KERNEL_ERR_STATE;
     }
 
+    // Timer task (CONFIG_TIMER_DAEMON): callbacks run in task context
+    if (timer_init() != KERNEL_OK) {
+        return KERNEL_ERR_STATE;
+    }
+
     g_kernel_state = KERNEL_STATE_INIT;
     return KERNEL_OK;
+#endif
 }
 
 void kernel_start(void)
@@ -112,7 +375,11 @@ void kernel_start(void)
     SYSTICK_CSR = SYSTICK_CSR_ENABLE | SYSTICK_CSR_TICKINT | SYSTICK_CSR_CLKSOURCE;
 
     g_kernel_state = KERNEL_STATE_RUNNING;
+#if CONFIG_CYCLIC_EXECUTIVE
+    cyclic_run();
+#else
     scheduler_start();
+#endif
 }
 
 kernel_state_t kernel_get_state(void)
@@ -122,22 +389,124 @@ kernel_state_t kernel_get_state(void)
 
 uint32_t kernel_get_tick(void)
 {
+#if CONFIG_CYCLIC_EXECUTIVE
+    return cyclic_get_tick();
+#else
     return scheduler_get_tick_count();
+#endif
 }
 
-int task_create(task_tcb_t *tcb,
-                const char *name,
-                void (*entry)(void *),
-                void *arg,
-                uint8_t priority,
-                uint32_t *stack,
-                uint32_t stack_size)
+/*
+ * Derive the cycle-to-ns multiplier with 32-bit divides only (the link
+ * has no libgcc for a 64-bit one): integer ns per cycle, then 32
+ * fraction bits by long division, keeping as many as fit in 32 bits.
+ */
+static void time_init(void)
+{
+    uint32_t hz = SystemCoreClock;
+    uint32_t whole = 1000000000UL / hz;
+    uint32_t rem = 1000000000UL % hz;
+    uint32_t frac = 0;
+    uint32_t shift = 32U;
+    uint32_t i;
+
+    for (i = 0; i < 32U; i++) {
+        uint64_t r = (uint64_t)rem << 1;
+
+        frac <<= 1;
+        if (r >= hz) {
+            r -= hz;
+            frac |= 1U;
+        }
+        rem = (uint32_t)r;
+    }
+
+    // Keep the multiplier (and each reading's product) within 32 bits
+    while (shift > 31U || (whole >> (32U - shift)) != 0U) {
+        shift--;
+    }
+    g_time_mult = (whole << shift) | (frac >> (32U - shift));
+    g_time_shift = shift;
+
+    g_time_epoch[0].cycles = 0;
+    g_time_epoch[0].ns = 0;
+    g_time_epoch[0].ns_frac = 0;
+    g_time_epoch[0].anchor = DWT_CYCCNT;
+    g_time_gen = 0;
+}
+
+// Called from SysTick context (the only writer)
+void kernel_time_tick(void)
 {
+    uint32_t gen = g_time_gen;
+    const time_epoch_t *cur = &g_time_epoch[gen & 1U];
+    time_epoch_t *next = &g_time_epoch[(gen + 1U) & 1U];
+    uint32_t now = DWT_CYCCNT;
+    uint32_t delta = now - cur->anchor;
+    uint64_t scaled = (uint64_t)cur->ns_frac + (uint64_t)delta * g_time_mult;
+
+    next->cycles = cur->cycles + delta;
+    next->ns = cur->ns + (scaled >> g_time_shift);
+    next->ns_frac = (uint32_t)scaled & ((1UL << g_time_shift) - 1U);
+    next->anchor = now;
+    __DMB();
+    g_time_gen = gen + 1U;
+}
+
+// Consistent epoch plus the CYCCNT delta since its anchor
+static uint32_t time_read(time_epoch_t *epoch)
+{
+    uint32_t gen;
+    uint32_t now;
+
+    do {
+        gen = g_time_gen;
+        __DMB();
+        *epoch = g_time_epoch[gen & 1U];
+        now = DWT_CYCCNT;
+        __DMB();
+    } while (gen != g_time_gen);
+
+    return now - epoch->anchor;
+}
+
+uint64_t kernel_time_cycles(void)
+{
+    time_epoch_t epoch;
+    uint32_t delta = time_read(&epoch);
+
+    return epoch.cycles + delta;
+}
+
+uint64_t kernel_time_ns(void)
+{
+    time_epoch_t epoch;
+    uint32_t delta = time_read(&epoch);
+
+    return epoch.ns +
+           (((uint64_t)epoch.ns_frac + (uint64_t)delta * g_time_mult) >> g_time_shift);
+}
+
+// Allocate and initialize a task without making it schedulable yet
+static int task_prepare(task_tcb_t **ptcb,
+                        const char *name,
+                        void (*entry)(void *),
+                        void *arg,
+                        uint8_t priority,
+                        uint32_t *stack,
+                        uint32_t stack_size,
+                        uint8_t flags)
+{
+    task_tcb_t *tcb = *ptcb;
     int tcb_slot = -1;
     int stack_slot = -1;
     uint32_t *stack_top;
+    bool fill;
+#if CONFIG_JITTER_HIST
+    uint32_t i;
+#endif
 
-    if (entry == NULL || priority >= CONFIG_MAX_PRIORITY) {
+    if (entry == NULL || !priority_valid(priority)) {
         return KERNEL_ERR_PARAM;
     }
 
@@ -173,13 +542,23 @@ int task_create(task_tcb_t *tcb,
     }
 
     // Fill stack with a known pattern for post-mortem usage checks
-    {
+    // (a group stack may be in use by another member: leave it)
+    fill = !(flags & TASK_FLAG_SHARED_STACK);
+#if CONFIG_STACK_CHECK
+    // ...unless no member has filled it yet (no guard word)
+    fill = fill || stack[0] != CONFIG_STACK_GUARD_WORD;
+#endif
+    if (fill) {
         uint32_t words = stack_size / sizeof(uint32_t);
         uint32_t i;
         for (i = 0; i < words; i++) {
             stack[i] = TASK_STACK_FILL;
         }
     }
+#if CONFIG_STACK_CHECK
+    // Lowest word: PendSV checks it on every switch away from the task
+    stack[0] = CONFIG_STACK_GUARD_WORD;
+#endif
 
     stack_top = (uint32_t *)(((uintptr_t)(stack + (stack_size / sizeof(uint32_t)))) & ~((uintptr_t)0x7U));
 
@@ -190,7 +569,11 @@ int task_create(task_tcb_t *tcb,
     tcb->priority = priority;
     tcb->base_priority = priority;
     tcb->state = TASK_STATE_READY;
-    tcb->flags = 0;
+    tcb->flags = flags;
+    tcb->partition = PARTITION_SYSTEM;
+#if CONFIG_PREEMPT_THRESHOLD
+    tcb->threshold = priority;
+#endif
     tcb->next = NULL;
     tcb->prev = NULL;
     tcb->stack_base = stack;
@@ -203,18 +586,228 @@ int task_create(task_tcb_t *tcb,
     tcb->block_object = NULL;
     tcb->block_timeout = 0;
     tcb->block_result = KERNEL_OK;
+    tcb->mutex_held = NULL;
+    tcb->wait_head = NULL;
+    tcb->wait_tail = NULL;
+    tcb->wait_next = NULL;
+    tcb->wait_prev = NULL;
+    tcb->period = 0;
+    tcb->rel_deadline = 0;
+    tcb->release_tick = 0;
+    tcb->deadline = 0;
+    tcb->deadline_misses = 0;
+    tcb->release_misses = 0;
+    tcb->wcet = 0;
+    tcb->edf_index = TASK_EDF_INDEX_NONE;
     tcb->event_wait_bits = 0;
     tcb->event_wait_all = 0;
-#ifdef CONFIG_TASK_STATS
+#if CONFIG_TASK_NOTIFY
+    tcb->notify_value = 0;
+    tcb->notify_pending = 0;
+#endif
+#if CONFIG_TASK_STATS
     tcb->run_count = 0;
     tcb->total_ticks = 0;
     tcb->max_stack_used = 0;
+    tcb->total_cycles = 0;
+#endif
+#if CONFIG_STACK_CHECK && CONFIG_TASK_STATS && !CONFIG_CYCLIC_EXECUTIVE
+    tcb->list_next = NULL;
+#endif
+#if CONFIG_JITTER_HIST
+    for (i = 0; i < CONFIG_JITTER_HIST_BUCKETS; i++) {
+        tcb->jitter_hist[i] = 0;
+    }
+    tcb->jitter_max = 0;
+#endif
+#if CONFIG_CPU_BUDGET
+    tcb->budget_cycles = 0;
+    tcb->budget_used = 0;
+    tcb->budget_period = 0;
+    tcb->budget_replenish = 0;
+    tcb->budget_overruns = 0;
+    tcb->budget_next = NULL;
+    tcb->budget_policy = BUDGET_POLICY_HOOK;
+    tcb->budget_depleted = 0;
+#endif
+
+    // A group stack gets the frame at dispatch (task_job_restart)
+    if (flags & TASK_FLAG_SHARED_STACK) {
+        tcb->sp = NULL;
+    } else {
+        tcb->sp = task_init_stack(stack_top, entry, arg, task_exit_trampoline);
+    }
+    *ptcb = tcb;
+
+    return KERNEL_OK;
+}
+
+// Give pool slots of a prepared but never scheduled task back
+static void task_release_slots(task_tcb_t *tcb)
+{
+    uint32_t i;
+
+    if (tcb >= &g_task_pool[0] && tcb < &g_task_pool[CONFIG_MAX_TASKS]) {
+        free_slot(g_task_slot_used, (int)(tcb - g_task_pool));
+    }
+    for (i = 0; i < CONFIG_MAX_TASKS; i++) {
+        if (tcb->stack_base == g_stack_pool[i]) {
+            free_slot(g_stack_slot_used, (int)i);
+        }
+    }
+}
+
+#if CONFIG_STACK_CHECK && CONFIG_TASK_STATS && !CONFIG_CYCLIC_EXECUTIVE
+// Caller holds a critical section
+static void task_list_add(task_tcb_t *tcb)
+{
+    tcb->list_next = g_task_list;
+    g_task_list = tcb;
+}
+
+/*
+ * Caller holds a critical section; a TCB that was never listed is
+ * ignored. Every path that retires a task (task_delete() and
+ * kernel_stack_overflow()) comes through here, so the scan cursor is
+ * moved off it before its stack can be reused.
+ */
+static void task_list_remove(task_tcb_t *tcb)
+{
+    task_tcb_t **link = &g_task_list;
+
+    while (*link != NULL && *link != tcb) {
+        link = &(*link)->list_next;
+    }
+    if (*link == NULL) {
+        return;
+    }
+    *link = tcb->list_next;
+    if (g_scan_task == tcb) {
+        g_scan_task = tcb->list_next;
+        g_scan_word = 1;
+    }
+}
+#else
+static inline void task_list_add(task_tcb_t *tcb)
+{
+    (void)tcb;
+}
+
+static inline void task_list_remove(task_tcb_t *tcb)
+{
+    (void)tcb;
+}
 #endif
 
-    tcb->sp = task_init_stack(stack_top, entry, arg, task_exit_trampoline);
+int task_create(task_tcb_t *tcb,
+                const char *name,
+                void (*entry)(void *),
+                void *arg,
+                uint8_t priority,
+                uint32_t *stack,
+                uint32_t stack_size)
+{
+    uint32_t irq_state;
+    int ret = task_prepare(&tcb, name, entry, arg, priority, stack, stack_size, 0U);
+
+    if (ret != KERNEL_OK) {
+        return ret;
+    }
+
+    irq_state = critical_enter();
+    task_list_add(tcb);
+    scheduler_add_task(tcb);
+    critical_exit(irq_state);
+    return KERNEL_OK;
+}
+
+int task_create_periodic(task_tcb_t *tcb,
+                         const char *name,
+                         void (*job)(void *),
+                         void *arg,
+                         uint8_t priority,
+                         uint32_t *stack,
+                         uint32_t stack_size,
+                         uint32_t period,
+                         uint32_t rel_deadline,
+                         uint32_t wcet)
+{
+    uint32_t irq_state;
+    int ret;
+
+    if (rel_deadline == 0U) {
+        rel_deadline = period;
+    }
+    if (job == NULL || period == 0U || period > PERIODIC_MAX_TICKS ||
+        wcet == 0U || wcet > rel_deadline || rel_deadline > period) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    ret = task_prepare(&tcb, name, periodic_job_entry, arg, priority, stack, stack_size, 0U);
+    if (ret != KERNEL_OK) {
+        return ret;
+    }
+    tcb->entry = job;
+    tcb->wcet = wcet;
+
+    // Admission and release happen atomically against other creators
+    irq_state = critical_enter();
+    if (!periodic_admit(tcb, priority, period, rel_deadline, wcet)) {
+        critical_exit(irq_state);
+        task_release_slots(tcb);
+        return KERNEL_ERR_OVERLOAD;
+    }
+    task_list_add(tcb);
     scheduler_add_task(tcb);
+    scheduler_set_deadline(tcb, period, rel_deadline);
+    critical_exit(irq_state);
+
+    return KERNEL_OK;
+}
+
+int task_create_shared(task_tcb_t *tcb,
+                       const char *name,
+                       void (*job)(void *),
+                       void *arg,
+                       uint8_t priority,
+                       task_stack_group_t *group)
+{
+#if CONFIG_PREEMPT_THRESHOLD
+    uint32_t irq_state;
+    int ret;
+
+    // A member above the group threshold could preempt the stack owner
+    if (job == NULL || group == NULL || group->stack == NULL ||
+        !priority_valid(group->threshold) || priority < group->threshold) {
+        return KERNEL_ERR_PARAM;
+    }
 
+    ret = task_prepare(&tcb, name, shared_job_entry, arg, priority,
+                       group->stack, group->size,
+                       TASK_FLAG_SHARED_STACK | TASK_FLAG_STACK_DROPPED);
+    if (ret != KERNEL_OK) {
+        return ret;
+    }
+    tcb->entry = job;
+    tcb->threshold = group->threshold;
+
+    // Idle until the first notification; not queued anywhere meanwhile
+    tcb->state = TASK_STATE_BLOCKED;
+    tcb->block_reason = BLOCK_JOB;
+
+    irq_state = critical_enter();
+    task_list_add(tcb);
+    critical_exit(irq_state);
     return KERNEL_OK;
+#else
+    (void)tcb;
+    (void)name;
+    (void)job;
+    (void)arg;
+    (void)priority;
+    (void)group;
+    return KERNEL_ERR_STATE;
+#endif
 }
 
 int task_delete(task_tcb_t *tcb)
@@ -230,6 +823,8 @@ int task_delete(task_tcb_t *tcb)
 
     irq_state = critical_enter();
     scheduler_remove_task(tcb);
+    periodic_withdraw(tcb);
+    task_list_remove(tcb);
     tcb->state = TASK_STATE_DELETED;
     critical_exit(irq_state);
 
@@ -264,12 +859,21 @@ int task_suspend(task_tcb_t *tcb)
 
 int task_resume(task_tcb_t *tcb)
 {
-    if (tcb == NULL || tcb->state != TASK_STATE_SUSPENDED) {
+    uint32_t irq_state;
+
+    if (tcb == NULL) {
         return KERNEL_ERR_PARAM;
     }
 
+    // Checked and requeued as one step against a racing resume or delete
+    irq_state = critical_enter();
+    if (tcb->state != TASK_STATE_SUSPENDED) {
+        critical_exit(irq_state);
+        return KERNEL_ERR_PARAM;
+    }
     tcb->state = TASK_STATE_READY;
     scheduler_add_task(tcb);
+    critical_exit(irq_state);
     return KERNEL_OK;
 }
 
@@ -288,6 +892,68 @@ void task_delay(uint32_t ticks)
     (void)scheduler_block_task(BLOCK_DELAY, NULL, ticks);
 }
 
+#if CONFIG_JITTER_HIST
+// Cycles from the release tick's interrupt to now, into the histogram
+static void jitter_record(task_tcb_t *tcb, uint32_t release_tick)
+{
+    uint32_t tick_cycles = SystemCoreClock / CONFIG_TICK_RATE_HZ;
+    uint32_t irq_state, tick, since, late, bucket;
+    uint64_t total;
+
+    // The time base epoch is re-anchored by the same interrupt as the tick
+    irq_state = critical_enter();
+    tick = scheduler_get_tick_count();
+    since = DWT_CYCCNT - g_time_epoch[g_time_gen & 1U].anchor;
+    critical_exit(irq_state);
+
+    total = (uint64_t)(tick - release_tick) * tick_cycles + since;
+    late = (total > UINT32_MAX) ? UINT32_MAX : (uint32_t)total;
+
+    bucket = 0;
+    if (late >= (1UL << TASK_JITTER_SHIFT)) {
+        bucket = 32U - (uint32_t)__builtin_clz(late) - TASK_JITTER_SHIFT;
+        if (bucket >= CONFIG_JITTER_HIST_BUCKETS) {
+            bucket = CONFIG_JITTER_HIST_BUCKETS - 1U;
+        }
+    }
+    tcb->jitter_hist[bucket]++;
+    if (late > tcb->jitter_max) {
+        tcb->jitter_max = late;
+    }
+}
+#endif
+
+int task_delay_until(uint32_t *last_wake, uint32_t period)
+{
+    task_tcb_t *self = scheduler_get_current();
+    uint32_t release, behind;
+    int res;
+
+    if (last_wake == NULL || period == 0U || period > (uint32_t)INT32_MAX) {
+        return KERNEL_ERR_PARAM;
+    }
+    if (self == NULL) {
+        return KERNEL_ERR_STATE;
+    }
+
+    release = *last_wake + period;
+    res = scheduler_block_until(BLOCK_DELAY, release);
+    if (res == KERNEL_ERR_TIMEOUT) {
+        // Stay on the grid: skip to the latest release not in the future
+        behind = scheduler_get_tick_count() - release;
+        release += (behind / period) * period;
+        self->release_misses += (behind / period) + 1U;
+    } else if (res != KERNEL_OK) {
+        return res;
+    }
+
+    *last_wake = release;
+#if CONFIG_JITTER_HIST
+    jitter_record(self, release);
+#endif
+    return res;
+}
+
 task_tcb_t *task_get_current(void)
 {
     return scheduler_get_current();
@@ -295,7 +961,9 @@ task_tcb_t *task_get_current(void)
 
 int task_set_priority(task_tcb_t *tcb, uint8_t priority)
 {
-    if (priority >= CONFIG_MAX_PRIORITY) {
+    uint32_t irq_state;
+
+    if (!priority_valid(priority)) {
         return KERNEL_ERR_PARAM;
     }
     if (tcb == NULL) {
@@ -304,11 +972,111 @@ int task_set_priority(task_tcb_t *tcb, uint8_t priority)
     if (tcb == NULL) {
         return KERNEL_ERR_PARAM;
     }
+#if CONFIG_PREEMPT_THRESHOLD
+    if ((tcb->flags & TASK_FLAG_SHARED_STACK) && priority < tcb->threshold) {
+        return KERNEL_ERR_PARAM;
+    }
+#endif
+
+    irq_state = critical_enter();
+    if (!periodic_reprioritize(tcb, priority)) {
+        critical_exit(irq_state);
+        return KERNEL_ERR_OVERLOAD;
+    }
+    // Mutexes still held may keep the task above its new base
+    tcb->base_priority = priority;
+    mutex_priority_update(tcb);
+    critical_exit(irq_state);
+    return KERNEL_OK;
+}
+
+int task_set_deadline(task_tcb_t *tcb, uint32_t period, uint32_t rel_deadline)
+{
+    periodic_entry_t *entry;
+    uint32_t irq_state;
+
+    if (tcb == NULL) {
+        tcb = task_get_current();
+    }
+    if (tcb == NULL || rel_deadline == 0U ||
+        (period != 0U && rel_deadline > period)) {
+        return KERNEL_ERR_PARAM;
+    }
 
-    scheduler_set_priority(tcb, priority);
+    irq_state = critical_enter();
+    entry = periodic_find(tcb);
+    // An admitted task stays periodic, with a deadline its WCET fits in
+    if (entry != NULL) {
+        if (period == 0U || period > PERIODIC_MAX_TICKS || entry->wcet > rel_deadline) {
+            critical_exit(irq_state);
+            return KERNEL_ERR_PARAM;
+        }
+        if (!periodic_retime(entry, period, rel_deadline)) {
+            critical_exit(irq_state);
+            return KERNEL_ERR_OVERLOAD;
+        }
+    }
+    scheduler_set_deadline(tcb, period, rel_deadline);
+    critical_exit(irq_state);
     return KERNEL_OK;
 }
 
+int task_wait_next_period(void)
+{
+    return scheduler_wait_next_period();
+}
+
+int task_set_budget(task_tcb_t *tcb, uint32_t cycles, uint32_t period, uint8_t policy)
+{
+#if CONFIG_CPU_BUDGET
+    if (tcb == NULL) {
+        tcb = task_get_current();
+    }
+    if (tcb == NULL || policy > BUDGET_POLICY_SUSPEND ||
+        (cycles != 0U && period == 0U)) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    scheduler_set_budget(tcb, cycles, period, policy);
+    return KERNEL_OK;
+#else
+    (void)tcb;
+    (void)cycles;
+    (void)period;
+    (void)policy;
+    return KERNEL_ERR_STATE;
+#endif
+}
+
+int task_set_threshold(task_tcb_t *tcb, uint8_t threshold)
+{
+#if CONFIG_PREEMPT_THRESHOLD
+    uint32_t irq_state;
+
+    if (tcb == NULL) {
+        tcb = task_get_current();
+    }
+    if (tcb == NULL || !priority_valid(threshold) ||
+        threshold > tcb->base_priority ||
+        (tcb->flags & TASK_FLAG_SHARED_STACK)) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    irq_state = critical_enter();
+    tcb->threshold = threshold;
+    // A task holding its threshold moves to the new level right away
+    if (tcb->flags & TASK_FLAG_THRESHOLD) {
+        mutex_priority_update(tcb);
+    }
+    critical_exit(irq_state);
+    return KERNEL_OK;
+#else
+    (void)tcb;
+    (void)threshold;
+    return KERNEL_ERR_STATE;
+#endif
+}
+
 // Weak defaults let applications add behavior without touching kernel internals
 void kernel_idle_hook(void)
 {
@@ -325,6 +1093,31 @@ void kernel_stack_overflow_hook(task_tcb_t *tcb)
     while (1) { __WFI(); }
 }
 
+void kernel_budget_overrun_hook(task_tcb_t *tcb)
+{
+    (void)tcb;
+}
+
+#if CONFIG_STACK_CHECK
+/*
+ * Called by PendSV, interrupts masked, when the outgoing task saved its
+ * context at or below its stack base or its guard word is gone. The
+ * stack is corrupt, so the task never runs again even if the hook
+ * returns.
+ */
+void kernel_stack_overflow(task_tcb_t *tcb)
+{
+#if CONFIG_STACK_OVERFLOW_HOOK
+    kernel_stack_overflow_hook(tcb);
+#endif
+    scheduler_remove_task(tcb);
+    periodic_withdraw(tcb);
+    // Also moves the idle scan off the task, as for task_delete()
+    task_list_remove(tcb);
+    tcb->state = TASK_STATE_DELETED;
+}
+#endif
+
 void kernel_assert_failed(const char *file, int line)
 {
     (void)file;
@@ -350,15 +1143,16 @@ int svc_dispatch(uint32_t svc_num, uint32_t arg0, uint32_t arg1, uint32_t arg2)
         task_delay(arg0);
         return KERNEL_OK;
     case SVC_TASK_DELETE:
-        return task_delete((task_tcb_t *)arg0);
+        return task_delete((task_tcb_t *)(uintptr_t)arg0);
     case SVC_TASK_SUSPEND:
-        return task_suspend((task_tcb_t *)arg0);
+        return task_suspend((task_tcb_t *)(uintptr_t)arg0);
     case SVC_TASK_RESUME:
-        return task_resume((task_tcb_t *)arg0);
+        return task_resume((task_tcb_t *)(uintptr_t)arg0);
     case SVC_TASK_PRIORITY:
-        return task_set_priority((task_tcb_t *)arg0, (uint8_t)arg1);
+        return task_set_priority((task_tcb_t *)(uintptr_t)arg0, (uint8_t)arg1);
     case SVC_TASK_CREATE:
-        return task_create((task_tcb_t *)arg0, NULL, (void (*)(void *))arg1, (void *)arg2,
+        return task_create((task_tcb_t *)(uintptr_t)arg0, NULL,
+                           (void (*)(void *))(uintptr_t)arg1, (void *)(uintptr_t)arg2,
                            (uint8_t)(CONFIG_MAX_PRIORITY - 2U), NULL, CONFIG_DEFAULT_STACK_SIZE);
     default:
         return KERNEL_ERR_PARAM;
@@ -374,15 +1168,17 @@ uint32_t *task_init_stack(uint32_t *stack_top,
 
     // Hardware exception frame (restored on EXC_RETURN)
     *(--sp) = 0x01000000UL;           // xPSR (Thumb bit set) 
-    *(--sp) = (uint32_t)entry;        //PC 
-    *(--sp) = (uint32_t)exit_func;    // LR 
+    *(--sp) = (uint32_t)(uintptr_t)entry;      //PC 
+    *(--sp) = (uint32_t)(uintptr_t)exit_func;  // LR 
     *(--sp) = 0;                      // R12 
     *(--sp) = 0;                      // R3 
     *(--sp) = 0;                      // R2 
     *(--sp) = 0;                      // R1 
-    *(--sp) = (uint32_t)arg;          // R0 
+    *(--sp) = (uint32_t)(uintptr_t)arg;        // R0 
 
     // Software frame saved/restored by PendSV
+    // Tasks start without FP state; the first FP instruction sets
+    // CONTROL.FPCA and later switches see EXC_RETURN_THREAD_PSP_FPU
     *(--sp) = EXC_RETURN_THREAD_PSP;  // LR/EXC_RETURN for bx lr in PendSV 
     *(--sp) = 0;                      // R11 
     *(--sp) = 0;                      // R10 
@@ -396,16 +1192,229 @@ uint32_t *task_init_stack(uint32_t *stack_top,
     return sp;
 }
 
+#if CONFIG_TICKLESS_IDLE && !CONFIG_CYCLIC_EXECUTIVE
+/*
+ * Sleep through an idle stretch with the periodic tick stopped.
+ *
+ * SysTick is reloaded to fire once at the next timeout or timer expiry
+ * (bounded by its 24-bit counter). On wake the whole ticks that went by
+ * are credited to the scheduler and timers, and the counter restarts in
+ * phase with the original tick grid. After a full sleep the final tick
+ * is left pending so SysTick_Handler performs the actual wakeup.
+ *
+ * Returns: true if the CPU slept, false if the next deadline was too
+ *          close and the caller should idle normally.
+ */
+static bool tickless_sleep(void)
+{
+    uint32_t tick_cycles = SystemCoreClock / CONFIG_TICK_RATE_HZ;
+    uint32_t irq_state, idle_ticks, cycles, remaining, elapsed_ticks, next;
+
+    irq_state = critical_enter();
+
+    idle_ticks = scheduler_next_wake_ticks();
+#if CONFIG_SW_TIMERS
+    next = timer_next_expiry();
+    if (next < idle_ticks) {
+        idle_ticks = next;
+    }
+#endif
+    if (idle_ticks > SYSTICK_RVR_MAX / tick_cycles) {
+        idle_ticks = SYSTICK_RVR_MAX / tick_cycles;
+    }
+    if (idle_ticks < CONFIG_TICKLESS_MIN_TICKS) {
+        critical_exit(irq_state);
+        return false;
+    }
+
+    // Freeze the counter; a tick that already fired is serviced first
+    SYSTICK_CSR = SYSTICK_CSR_TICKINT | SYSTICK_CSR_CLKSOURCE;
+    remaining = SYSTICK_CVR;
+    if (remaining == 0U || (SCB_ICSR & SCB_ICSR_PENDSTSET) != 0U) {
+        SYSTICK_CSR = SYSTICK_CSR_ENABLE | SYSTICK_CSR_TICKINT | SYSTICK_CSR_CLKSOURCE;
+        critical_exit(irq_state);
+        return false;
+    }
+
+    // Writing CVR also clears a stale COUNTFLAG
+    cycles = remaining + tick_cycles * (idle_ticks - 1U);
+    SYSTICK_RVR = cycles - 1U;
+    SYSTICK_CVR = 0;
+    SYSTICK_CSR = SYSTICK_CSR_ENABLE | SYSTICK_CSR_TICKINT | SYSTICK_CSR_CLKSOURCE;
+
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    /*
+     * IRQs masked by BASEPRI do not wake WFI, so PRIMASK is held across
+     * the WFI alone; a zero-latency IRQ then runs right after wakeup
+     * while SysTick stays held off until the bookkeeping is done.
+     */
+    __disable_irq();
+    __DSB();
+    __WFI();
+    __enable_irq();
+#else
+    // PRIMASK is set: any IRQ still wakes WFI and is taken on exit below
+    __DSB();
+    __WFI();
+#endif
+    __ISB();
+
+    SYSTICK_CSR = SYSTICK_CSR_TICKINT | SYSTICK_CSR_CLKSOURCE;
+    remaining = SYSTICK_CVR;
+
+    if ((SYSTICK_CSR & SYSTICK_CSR_COUNTFLAG) != 0U) {
+        // Slept the whole way; the pending SysTick accounts the last tick
+        cycles = (remaining == 0U) ? 0U : (cycles - remaining);
+        elapsed_ticks = (idle_ticks - 1U) + (cycles / tick_cycles);
+        next = tick_cycles - (cycles % tick_cycles);
+    } else {
+        // Woken early by another interrupt: resume mid-period
+        cycles = (tick_cycles * idle_ticks) - remaining;
+        elapsed_ticks = cycles / tick_cycles;
+        next = remaining % tick_cycles;
+        if (next == 0U) {
+            next = tick_cycles;
+        }
+    }
+
+    // A boundary too close to reprogram for is credited now instead
+    if (next <= 1U) {
+        next += tick_cycles;
+        elapsed_ticks++;
+    }
+
+    SYSTICK_RVR = next - 1U;
+    SYSTICK_CVR = 0;
+    SYSTICK_CSR = SYSTICK_CSR_ENABLE | SYSTICK_CSR_TICKINT | SYSTICK_CSR_CLKSOURCE;
+    SYSTICK_RVR = tick_cycles - 1U;     // Takes effect at the next reload
+
+    if (elapsed_ticks > 0U) {
+        scheduler_advance_ticks(elapsed_ticks);
+#if CONFIG_SW_TIMERS
+        timer_advance(elapsed_ticks);
+#endif
+    }
+
+    critical_exit(irq_state);
+    return true;
+}
+#endif
+
 static void task_exit_trampoline(void)
 {
     (void)task_delete(NULL);
     while (1) { __WFI(); }
 }
 
+// Kernel-owned release loop: one job() call per period
+static void periodic_job_entry(void *arg)
+{
+    task_tcb_t *self = task_get_current();
+
+    while (1) {
+        self->entry(arg);
+        (void)task_wait_next_period();
+    }
+}
+
+#if CONFIG_PREEMPT_THRESHOLD
+/*
+ * Shared-stack job loop. Blocking in BLOCK_JOB gives up the stack: the
+ * task never returns from that call, it is restarted here by the next
+ * dispatch after a notification.
+ */
+static void shared_job_entry(void *arg)
+{
+    task_tcb_t *self = task_get_current();
+    uint32_t irq_state;
+    uint8_t pending;
+
+    while (1) {
+        irq_state = critical_enter();
+        pending = self->notify_pending;
+        self->notify_pending = 0U;
+        critical_exit(irq_state);
+
+        if (pending) {
+            self->entry(arg);
+        } else {
+            (void)scheduler_block_task(BLOCK_JOB, NULL, TIMEOUT_FOREVER);
+        }
+    }
+}
+
+void task_job_restart(task_tcb_t *tcb)
+{
+    tcb->sp = task_init_stack(tcb->stack_top, shared_job_entry, tcb->arg,
+                              task_exit_trampoline);
+}
+#endif
+
+#if CONFIG_STACK_CHECK && CONFIG_TASK_STATS && !CONFIG_CYCLIC_EXECUTIVE
+/*
+ * One bounded step of the high-water scan. Walks up from just above
+ * the guard word to the first word that lost the fill pattern, at most
+ * CONFIG_STACK_SCAN_WORDS per call, then moves on to the next task.
+ * Only words below the deepest use already recorded are looked at, but
+ * every pass restarts at the guard word: a settled task still costs its
+ * whole untouched region, split into CONFIG_STACK_SCAN_WORDS chunks.
+ */
+static void stack_scan_step(void)
+{
+    uint32_t irq_state = critical_enter();
+    task_tcb_t *tcb = g_scan_task;
+    uint32_t words, limit, end, i;
+
+    if (tcb == NULL) {
+        tcb = g_task_list;
+        g_scan_task = tcb;
+        g_scan_word = 1;
+        if (tcb == NULL) {
+            critical_exit(irq_state);
+            return;
+        }
+    }
+
+    words = tcb->stack_size / sizeof(uint32_t);
+    limit = words - (tcb->max_stack_used / sizeof(uint32_t));
+    end = g_scan_word + CONFIG_STACK_SCAN_WORDS;
+    if (end > limit) {
+        end = limit;
+    }
+
+    for (i = g_scan_word; i < end; i++) {
+        if (tcb->stack_base[i] != TASK_STACK_FILL) {
+            break;
+        }
+    }
+
+    if (i < end || end == limit) {
+        if (i < limit) {
+            tcb->max_stack_used = (words - i) * sizeof(uint32_t);
+        }
+        g_scan_task = tcb->list_next;
+        g_scan_word = 1;
+    } else {
+        g_scan_word = end;
+    }
+    critical_exit(irq_state);
+}
+#endif
+
+#if !CONFIG_CYCLIC_EXECUTIVE
 static void idle_task(void *arg)
 {
     (void)arg;
     while (1) {
+#if CONFIG_STACK_CHECK && CONFIG_TASK_STATS
+        stack_scan_step();
+#endif
+#if CONFIG_TICKLESS_IDLE
+        if (tickless_sleep()) {
+            continue;
+        }
+#endif
         kernel_idle_hook();
     }
 }
+#endif
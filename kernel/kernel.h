@@ -24,6 +24,16 @@
 #define KERNEL_ERR_STATE        -5      // Invalid state for operation
 #define KERNEL_ERR_DELETED      -6      // Object was deleted 
 #define KERNEL_ERR_OVERFLOW     -7      // Buffer/stack overflow 
+#define KERNEL_ERR_OVERLOAD     -8      // Task set fails admission test
+
+// CPU Budget Overrun Policies (task_set_budget)
+#define BUDGET_POLICY_HOOK      0       // Call kernel_budget_overrun_hook() 
+#define BUDGET_POLICY_DEMOTE    1       // Run at CONFIG_BUDGET_DEMOTE_PRIORITY until refill
+#define BUDGET_POLICY_SUSPEND   2       // Do not run until refill
+
+// Longest period task_create_periodic() accepts, in ticks (4.6 h at 1 kHz);
+// keeps the admission arithmetic inside 32 bits
+#define PERIODIC_MAX_TICKS      (1UL << 24)
 
 // Kernel State
 
@@ -77,6 +87,10 @@ int kernel_init(void);
  * Prerequisites:
  *   - kernel_init() called
  *   - At least one task created
+ *
+ * With CONFIG_CYCLIC_EXECUTIVE it enters the table dispatch loop
+ * instead; install the table with cyclic_set_table() first. There is
+ * no scheduler in that mode, so tasks are never dispatched.
  */
  
  
@@ -103,6 +117,29 @@ static inline uint32_t kernel_get_tick_rate(void)
     return CONFIG_TICK_RATE_HZ;
 }
 
+/*
+ * kernel_time_cycles - Core clock cycles since kernel_init()
+ *
+ * 64-bit and monotonic: DWT CYCCNT extended by an epoch the tick
+ * advances. Lock-free and safe from any context, including interrupts
+ * above CONFIG_KERNEL_MAX_SYSCALL_PRIORITY and ones that preempt the
+ * tick. Assumes SystemCoreClock does not change after kernel_init().
+ */
+
+uint64_t kernel_time_cycles(void);
+
+/*
+ * kernel_time_ns - Nanoseconds since kernel_init()
+ *
+ * Same clock and guarantees as kernel_time_cycles(), scaled with a
+ * fixed-point multiply (no 64-bit divide).
+ */
+
+uint64_t kernel_time_ns(void);
+
+// Called from SysTick context: advance the time base epoch
+void kernel_time_tick(void);
+
 // Task Management API
 
 /*
@@ -128,6 +165,61 @@ int task_create(task_tcb_t *tcb,
                 uint32_t *stack,
                 uint32_t stack_size);
 
+/*
+ * task_create_periodic - Create a kernel-released periodic task
+ *
+ * The kernel calls job(arg) once per period, starting now, and sleeps
+ * the task on the period grid between jobs; job() must return. The
+ * task is only created if the periodic task set, including it, passes
+ * the admission test (CONFIG_ADMISSION_CONTROL): response-time analysis
+ * for fixed priority, total density for the EDF class.
+ *
+ * @tcb, @name, @arg, @priority, @stack, @stack_size: As task_create()
+ * @job:          Job body, called once per release
+ * @period:       Release period in ticks, at most PERIODIC_MAX_TICKS
+ * @rel_deadline: Deadline relative to release (0 = period)
+ * @wcet:         Worst-case execution time per job in ticks
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_OVERLOAD if rejected, or error code
+ */
+
+int task_create_periodic(task_tcb_t *tcb,
+                         const char *name,
+                         void (*job)(void *),
+                         void *arg,
+                         uint8_t priority,
+                         uint32_t *stack,
+                         uint32_t stack_size,
+                         uint32_t period,
+                         uint32_t rel_deadline,
+                         uint32_t wcet);
+
+/*
+ * task_create_shared - Create a notification-released job task on a
+ *                      shared stack (CONFIG_PREEMPT_THRESHOLD)
+ *
+ * The kernel calls job(arg) once per task_notify() to the task. The job
+ * runs to completion and must not block; between jobs the task holds
+ * no stack, so all members of @group run on the group's one stack.
+ * Notifications that arrive while a job is pending coalesce, so a job
+ * should drain its input. Suspending a member abandons its current job.
+ *
+ * @tcb, @name, @arg: As task_create()
+ * @job:      Job body, called once per release
+ * @priority: Task priority, not above the group threshold
+ * @group:    Stack group (TASK_STACK_GROUP_DEFINE)
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if
+ *          thresholds are not configured
+ */
+
+int task_create_shared(task_tcb_t *tcb,
+                       const char *name,
+                       void (*job)(void *),
+                       void *arg,
+                       uint8_t priority,
+                       task_stack_group_t *group);
+
 /*
  * task_delete - Delete a task
  * 
@@ -139,6 +231,9 @@ int task_delete(task_tcb_t *tcb);
 /*
  * task_suspend - Suspend a task
  * 
+ * A task suspended while blocked is taken off its wait list; the call
+ * it was blocked in returns KERNEL_ERR_STATE once it is resumed.
+ * 
  * @tcb: Task to suspend (NULL = current task)
  */
  
@@ -177,6 +272,30 @@ static inline void task_delay_ms(uint32_t ms)
     task_delay((ms * CONFIG_TICK_RATE_HZ) / 1000);
 }
 
+/*
+ * task_delay_until - Delay current task until a fixed-phase release
+ *
+ * Blocks until tick *last_wake + period and advances *last_wake to it,
+ * so a loop released this way keeps its phase however long each pass
+ * runs. Initialize *last_wake with kernel_get_tick() before the loop.
+ *
+ * If that release is already past, returns at once and moves *last_wake
+ * to the latest release on the grid that is not in the future (no
+ * catch-up burst); each period boundary passed counts in the task's
+ * release_misses. With CONFIG_JITTER_HIST every release also records
+ * its lateness in the task's jitter_hist / jitter_max.
+ *
+ * @last_wake: Release tick of the previous pass (updated)
+ * @period:    Period in ticks (below 2^31)
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_TIMEOUT if the release was missed,
+ *          KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if the caller cannot
+ *          block or was suspended while waiting (*last_wake is then
+ *          unchanged)
+ */
+
+int task_delay_until(uint32_t *last_wake, uint32_t period);
+
 /*
  * task_get_current - Get pointer to current task TCB
  */
@@ -186,12 +305,84 @@ task_tcb_t *task_get_current(void);
 /*
  * task_set_priority - Change task priority
  * 
+ * A task from task_create_periodic() is re-checked against the
+ * admission test at its new priority and keeps the old one if the
+ * set would no longer be schedulable.
+ * 
  * @tcb:      Task to modify (NULL = current task)
  * @priority: New priority
+ * 
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_OVERLOAD
  */
  
 int task_set_priority(task_tcb_t *tcb, uint8_t priority);
 
+/*
+ * task_set_deadline - Give a task periodic, deadline-driven timing
+ *
+ * The first job is released now. With CONFIG_EDF the task joins the
+ * EDF class at CONFIG_EDF_PRIORITY, where ready tasks run in order of
+ * absolute deadline instead of FIFO. A task from task_create_periodic()
+ * must stay periodic and is re-checked against the admission test; it
+ * keeps its old timing if the set would no longer be schedulable.
+ *
+ * @tcb:          Task to modify (NULL = current task)
+ * @period:       Job period in ticks (0 = single deadline, no re-arm)
+ * @rel_deadline: Deadline relative to each release (<= period)
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_OVERLOAD
+ */
+
+int task_set_deadline(task_tcb_t *tcb, uint32_t period, uint32_t rel_deadline);
+
+/*
+ * task_wait_next_period - Finish the current job and wait for the next
+ *
+ * Releases stay on the period grid, so late wakeups never drift.
+ * The next job's deadline is re-armed automatically on release.
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_TIMEOUT if the finished job missed
+ *          its deadline, KERNEL_ERR_STATE if the wait was cut short by
+ *          task_suspend(), or KERNEL_ERR_PARAM for an aperiodic task
+ */
+
+int task_wait_next_period(void);
+
+/*
+ * task_set_budget - Limit a task's CPU time per replenish period
+ *
+ * Execution is measured in DWT cycles at every context switch and
+ * tick (time spent in ISRs is charged to the interrupted task). When
+ * a period's allowance is used up the policy is applied once; the
+ * budget refills at the next period boundary.
+ *
+ * @tcb:    Task to limit (NULL = current task)
+ * @cycles: Allowance per period in CPU cycles (0 = unlimited)
+ * @period: Replenish period in ticks
+ * @policy: BUDGET_POLICY_HOOK, _DEMOTE or _SUSPEND
+ *
+ * Returns: KERNEL_OK or KERNEL_ERR_PARAM
+ */
+
+int task_set_budget(task_tcb_t *tcb, uint32_t cycles, uint32_t period, uint8_t policy);
+
+/*
+ * task_set_threshold - Set a task's preemption threshold
+ *
+ * Once dispatched, the task runs at its threshold until it blocks or
+ * yields: only tasks of higher priority than the threshold preempt it,
+ * and it is not time-sliced. Cooperating tasks given a common threshold
+ * run each other to completion instead of switching back and forth.
+ *
+ * @tcb:       Task to modify (NULL = current task)
+ * @threshold: Threshold priority, at or above the task's base priority
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if
+ *          thresholds are not configured
+ */
+
+int task_set_threshold(task_tcb_t *tcb, uint8_t threshold);
+
 //Scheduler Control API
  
 /*
@@ -237,9 +428,23 @@ void kernel_tick_hook(void) __attribute__((weak));
 /*
  * kernel_stack_overflow_hook - Called on stack overflow detection
  * 
+ * Runs in PendSV with interrupts masked, when a task is switched out
+ * with its sp at or below its stack base or its guard word overwritten.
+ * If it returns, the task is deleted.
+ *
  * @tcb: Task that overflowed
  */
  
 void kernel_stack_overflow_hook(task_tcb_t *tcb) __attribute__((weak));
 
+/*
+ * kernel_budget_overrun_hook - Called when a task exhausts its budget
+ *
+ * Runs in kernel (tick or PendSV) context under BUDGET_POLICY_HOOK.
+ *
+ * @tcb: Task that overran
+ */
+
+void kernel_budget_overrun_hook(task_tcb_t *tcb) __attribute__((weak));
+
 #endif // KERNEL_H 
@@ -0,0 +1,135 @@
+// HelixRT - Time Partitioning Implementation
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/config.h"
+#include "partition.h"
+#include "kernel.h"
+#include "scheduler.h"
+#include "sync/critical.h"
+#include "../hal/imxrt1062.h"
+
+#if CONFIG_PARTITIONS
+
+#if CONFIG_PARTITION_TRACE_DEPTH
+// Switch trace ring; g_trace_count keeps counting past the depth
+static partition_trace_t g_trace[CONFIG_PARTITION_TRACE_DEPTH];
+static uint32_t g_trace_count = 0;
+#endif
+
+int partition_set_table(const partition_window_t *windows, uint32_t count)
+{
+    uint32_t i;
+
+    if (windows == NULL || count == 0U) {
+        return KERNEL_ERR_PARAM;
+    }
+    for (i = 0; i < count; i++) {
+        if (windows[i].ticks == 0U || windows[i].partition >= CONFIG_PARTITION_COUNT) {
+            return KERNEL_ERR_PARAM;
+        }
+    }
+
+    scheduler_set_partition_table(windows, count);
+    return KERNEL_OK;
+}
+
+int task_set_partition(task_tcb_t *tcb, uint8_t partition)
+{
+    if (tcb == NULL) {
+        tcb = task_get_current();
+    }
+    if (tcb == NULL || partition >= CONFIG_PARTITION_COUNT) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    scheduler_set_task_partition(tcb, partition);
+    return KERNEL_OK;
+}
+
+uint8_t partition_get_active(void)
+{
+    return scheduler_get_partition();
+}
+
+void partition_trace_record(uint8_t from, uint8_t to)
+{
+#if CONFIG_PARTITION_TRACE_DEPTH
+    partition_trace_t *entry = &g_trace[g_trace_count % CONFIG_PARTITION_TRACE_DEPTH];
+
+    entry->cycles = DWT_CYCCNT;
+    entry->tick = scheduler_get_tick_count();
+    entry->from = from;
+    entry->to = to;
+    g_trace_count++;
+#else
+    (void)from;
+    (void)to;
+#endif
+}
+
+uint32_t partition_trace_read(partition_trace_t *buf, uint32_t max)
+{
+#if CONFIG_PARTITION_TRACE_DEPTH
+    uint32_t first, n, i;
+    uint32_t irq_state;
+
+    if (buf == NULL) {
+        return 0;
+    }
+
+    irq_state = critical_enter();
+    n = (g_trace_count < CONFIG_PARTITION_TRACE_DEPTH) ? g_trace_count : CONFIG_PARTITION_TRACE_DEPTH;
+    if (n > max) {
+        n = max;
+    }
+    first = g_trace_count - n;
+    for (i = 0; i < n; i++) {
+        buf[i] = g_trace[(first + i) % CONFIG_PARTITION_TRACE_DEPTH];
+    }
+    critical_exit(irq_state);
+
+    return n;
+#else
+    (void)buf;
+    (void)max;
+    return 0;
+#endif
+}
+
+#else
+
+int partition_set_table(const partition_window_t *windows, uint32_t count)
+{
+    (void)windows;
+    (void)count;
+    return KERNEL_ERR_STATE;
+}
+
+int task_set_partition(task_tcb_t *tcb, uint8_t partition)
+{
+    (void)tcb;
+    (void)partition;
+    return KERNEL_ERR_STATE;
+}
+
+uint8_t partition_get_active(void)
+{
+    return PARTITION_SYSTEM;
+}
+
+void partition_trace_record(uint8_t from, uint8_t to)
+{
+    (void)from;
+    (void)to;
+}
+
+uint32_t partition_trace_read(partition_trace_t *buf, uint32_t max)
+{
+    (void)buf;
+    (void)max;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+// HelixRT - Time Partitioning API
+
+// Static major-frame partition scheduling. Each window of the frame
+// hands the CPU to one partition, and inside a window the normal
+// priority scheduler picks among that partition's ready tasks.
+
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <stdint.h>
+#include "task.h"
+
+// Partition 0 is eligible in every window (idle and kernel services)
+#define PARTITION_SYSTEM        0
+
+// One window of the major frame
+typedef struct {
+    uint8_t partition;              // Partition that owns the window
+    uint32_t ticks;                 // Window length in ticks
+} partition_window_t;
+
+// One recorded partition switch
+typedef struct {
+    uint32_t cycles;                // DWT CYCCNT at the switch
+    uint32_t tick;                  // Scheduler tick at the switch
+    uint8_t from;
+    uint8_t to;
+} partition_trace_t;
+
+// Declare a major frame table in flash
+#define PARTITION_FRAME_DEFINE(name, ...)                       \
+    static const partition_window_t name[] = { __VA_ARGS__ }
+
+#define PARTITION_FRAME_COUNT(name) (sizeof(name) / sizeof((name)[0]))
+
+// Partition API
+
+/*
+ * partition_set_table - Install the major frame and start its first window
+ *
+ * The table is used in place and must stay valid. Windows run in order
+ * and the frame repeats. Until a table is installed only partition 0
+ * runs.
+ *
+ * @windows: Window table
+ * @count:   Number of windows
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_STATE if
+ *          partitions are not configured
+ */
+
+int partition_set_table(const partition_window_t *windows, uint32_t count);
+
+/*
+ * task_set_partition - Move a task into a partition
+ *
+ * @tcb:       Task to move (NULL = current task)
+ * @partition: Target partition (< CONFIG_PARTITION_COUNT)
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM or KERNEL_ERR_STATE
+ */
+
+int task_set_partition(task_tcb_t *tcb, uint8_t partition);
+
+/*
+ * partition_get_active - Partition owning the current window
+ */
+
+uint8_t partition_get_active(void);
+
+/*
+ * partition_trace_read - Copy recorded partition switches, oldest first
+ *
+ * @buf: Destination
+ * @max: Capacity of @buf in entries
+ *
+ * Returns: Number of entries copied
+ */
+
+uint32_t partition_trace_read(partition_trace_t *buf, uint32_t max);
+
+/*
+ * partition_trace_record - Log a partition switch (called by the tick)
+ */
+
+void partition_trace_record(uint8_t from, uint8_t to);
+
+#endif // PARTITION_H
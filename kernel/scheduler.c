@@ -11,73 +11,670 @@
 #include "scheduler.h"
 #include "kernel.h"
 #include "timer.h"
+#include "hrtimer.h"
 #include "sync/critical.h"
+#include "sync/mutex.h"
+#include "sync/semaphore.h"
+#include "sync/queue.h"
+#include "sync/event.h"
+#include "../hal/imxrt1062.h"
 
 task_tcb_t *current_task = NULL;
 task_tcb_t *next_task = NULL;
 
 static scheduler_t g_sched;
 static volatile uint32_t g_tick_count = 0;
-static task_tcb_t *g_blocked_head = NULL;
+
+/*
+ * Timeout list: blocked tasks with a finite timeout, sorted by expiry.
+ * Each entry's delay_ticks holds the ticks remaining after the previous
+ * entry expires, so the tick only ever touches the head and wraparound
+ * of the absolute tick count never matters.
+ */
+static task_tcb_t *g_timeout_head = NULL;
+
+#if CONFIG_TASK_STATS || CONFIG_CPU_BUDGET
+// DWT CYCCNT at the last accounting point (context switch or tick)
+static uint32_t g_account_cycles = 0;
+#endif
+
+#if CONFIG_CPU_BUDGET
+// Tasks whose budget ran out, linked via budget_next until refill
+static task_tcb_t *g_budget_depleted = NULL;
+#endif
+
+#if CONFIG_PARTITIONS
+// Major frame: window table, current window and ticks left in it
+static const partition_window_t *g_windows = NULL;
+static uint32_t g_window_count = 0;
+static uint32_t g_window_index = 0;
+static uint32_t g_window_left = 0;
+#endif
+
+// Wrap-safe "a is earlier than b" for tick timestamps
+static inline bool deadline_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+#if CONFIG_EDF
+/*
+ * EDF class: tasks flagged TASK_FLAG_EDF and sitting at
+ * CONFIG_EDF_PRIORITY are kept in a binary min-heap on absolute
+ * deadline instead of the FIFO ready list. Insert and remove are
+ * O(log n); the earliest deadline is always edf_heap[0]. A task whose
+ * priority is boosted away from the EDF level (e.g. by inheritance)
+ * drops back to the FIFO list of its new priority.
+ */
+
+static inline bool edf_class(const task_tcb_t *tcb)
+{
+    return (tcb->flags & TASK_FLAG_EDF) != 0U &&
+           tcb->priority == CONFIG_EDF_PRIORITY;
+}
+
+static void edf_place(task_tcb_t *tcb, uint32_t idx)
+{
+    g_sched.edf_heap[idx] = tcb;
+    tcb->edf_index = (uint16_t)idx;
+}
+
+static void edf_sift_up(uint32_t idx)
+{
+    task_tcb_t *tcb = g_sched.edf_heap[idx];
+
+    while (idx > 0U) {
+        uint32_t parent = (idx - 1U) / 2U;
+        if (!deadline_before(tcb->deadline, g_sched.edf_heap[parent]->deadline)) {
+            break;
+        }
+        edf_place(g_sched.edf_heap[parent], idx);
+        idx = parent;
+    }
+    edf_place(tcb, idx);
+}
+
+static void edf_sift_down(uint32_t idx)
+{
+    task_tcb_t *tcb = g_sched.edf_heap[idx];
+    uint32_t child;
+
+    while ((child = (2U * idx) + 1U) < g_sched.edf_count) {
+        if (child + 1U < g_sched.edf_count &&
+            deadline_before(g_sched.edf_heap[child + 1U]->deadline,
+                            g_sched.edf_heap[child]->deadline)) {
+            child++;
+        }
+        if (!deadline_before(g_sched.edf_heap[child]->deadline, tcb->deadline)) {
+            break;
+        }
+        edf_place(g_sched.edf_heap[child], idx);
+        idx = child;
+    }
+    edf_place(tcb, idx);
+}
+
+static void edf_insert(task_tcb_t *tcb)
+{
+    KERNEL_ASSERT(g_sched.edf_count < CONFIG_EDF_MAX_TASKS);
+
+    tcb->next = NULL;
+    tcb->prev = NULL;
+    g_sched.edf_heap[g_sched.edf_count] = tcb;
+    g_sched.edf_count++;
+    edf_sift_up(g_sched.edf_count - 1U);
+    bitmap_set(&g_sched.ready[0].priority_bitmap, CONFIG_EDF_PRIORITY);
+}
+
+static void edf_remove(task_tcb_t *tcb)
+{
+    uint32_t idx = tcb->edf_index;
+    task_tcb_t *last;
+
+    tcb->edf_index = TASK_EDF_INDEX_NONE;
+    g_sched.edf_count--;
+    last = g_sched.edf_heap[g_sched.edf_count];
+    if (last != tcb) {
+        edf_place(last, idx);
+        edf_sift_up(idx);
+        edf_sift_down(last->edf_index);
+    }
+
+    if (g_sched.edf_count == 0U && g_sched.ready[0].ready_list[CONFIG_EDF_PRIORITY] == NULL) {
+        bitmap_clear(&g_sched.ready[0].priority_bitmap, CONFIG_EDF_PRIORITY);
+    }
+}
+#endif
+
+// The EDF level stays marked ready while its heap holds tasks
+static inline bool edf_level_busy(uint8_t prio)
+{
+#if CONFIG_EDF
+    return prio == CONFIG_EDF_PRIORITY && g_sched.edf_count > 0U;
+#else
+    (void)prio;
+    return false;
+#endif
+}
+
+// Ready queue a task belongs to
+static inline ready_queue_t *task_queue(const task_tcb_t *tcb)
+{
+#if CONFIG_PARTITIONS
+    return &g_sched.ready[tcb->partition];
+#else
+    (void)tcb;
+    return &g_sched.ready[0];
+#endif
+}
 
 static void ready_insert_tail(task_tcb_t *tcb)
 {
-    task_tcb_t *head;
     uint8_t prio = tcb->priority;
+    ready_queue_t *q = task_queue(tcb);
+    task_tcb_t *tail = q->ready_tail[prio];
+
+#if CONFIG_EDF
+    if (edf_class(tcb)) {
+        edf_insert(tcb);
+        return;
+    }
+#endif
 
     tcb->next = NULL;
+    tcb->prev = tail;
+
+    if (tail == NULL) {
+        q->ready_list[prio] = tcb;
+        bitmap_set(&q->priority_bitmap, prio);
+    } else {
+        tail->next = tcb;
+    }
+    q->ready_tail[prio] = tcb;
+}
+
+// Front of its level: used when the running task is boosted
+static void ready_insert_head(task_tcb_t *tcb)
+{
+    uint8_t prio = tcb->priority;
+    ready_queue_t *q = task_queue(tcb);
+    task_tcb_t *head = q->ready_list[prio];
+
+#if CONFIG_EDF
+    if (edf_class(tcb)) {
+        edf_insert(tcb);
+        return;
+    }
+#endif
+
     tcb->prev = NULL;
+    tcb->next = head;
 
-    head = g_sched.ready_list[prio];
     if (head == NULL) {
-        g_sched.ready_list[prio] = tcb;
-        bitmap_set(&g_sched.priority_bitmap, prio);
+        q->ready_tail[prio] = tcb;
+        bitmap_set(&q->priority_bitmap, prio);
+    } else {
+        head->prev = tcb;
+    }
+    q->ready_list[prio] = tcb;
+}
+
+static void ready_remove(task_tcb_t *tcb)
+{
+    uint8_t prio = tcb->priority;
+    ready_queue_t *q = task_queue(tcb);
+
+#if CONFIG_EDF
+    if (tcb->edf_index != TASK_EDF_INDEX_NONE) {
+        edf_remove(tcb);
         return;
     }
+#endif
 
-    while (head->next != NULL) {
-        head = head->next;
+    if (tcb->prev != NULL) {
+        tcb->prev->next = tcb->next;
+    } else if (q->ready_list[prio] == tcb) {
+        q->ready_list[prio] = tcb->next;
+    } else {
+        return;     // Not queued
     }
-    head->next = tcb;
-    tcb->prev = head;
+
+    if (tcb->next != NULL) {
+        tcb->next->prev = tcb->prev;
+    } else {
+        q->ready_tail[prio] = tcb->prev;
+    }
+
+    if (q->ready_list[prio] == NULL && !edf_level_busy(prio)) {
+        bitmap_clear(&q->priority_bitmap, prio);
+    }
+
+    tcb->next = NULL;
+    tcb->prev = NULL;
 }
 
-static void blocked_insert(task_tcb_t *tcb)
+// True if a newly ready task should take the CPU from the running one
+static bool preempts_current(const task_tcb_t *tcb)
 {
-    tcb->next = g_blocked_head;
-    tcb->prev = NULL;
-    if (g_blocked_head != NULL) {
-        g_blocked_head->prev = tcb;
+    if (current_task == NULL) {
+        return false;
+    }
+#if CONFIG_PARTITIONS
+    // Tasks of a partition outside its window wait for the window
+    if (tcb->partition != PARTITION_SYSTEM &&
+        tcb->partition != g_sched.active_partition) {
+        return false;
+    }
+#endif
+    if (tcb->priority != current_task->priority) {
+        return tcb->priority < current_task->priority;
+    }
+#if CONFIG_EDF
+    return edf_class(tcb) && edf_class(current_task) &&
+           deadline_before(tcb->deadline, current_task->deadline);
+#else
+    return false;
+#endif
+}
+
+// Start the next job of a periodic task on its release grid
+static void job_release(task_tcb_t *tcb)
+{
+    tcb->release_tick += tcb->period;
+    tcb->deadline = tcb->release_tick + tcb->rel_deadline;
+}
+
+// Result handed to a task whose timeout-list entry expired
+static int expiry_result(const task_tcb_t *tcb)
+{
+    return (tcb->block_reason == BLOCK_DELAY || tcb->block_reason == BLOCK_PERIOD) ?
+           KERNEL_OK : KERNEL_ERR_TIMEOUT;
+}
+
+static void timeout_insert(task_tcb_t *tcb, uint32_t ticks)
+{
+    task_tcb_t *iter = g_timeout_head;
+    task_tcb_t *prev = NULL;
+
+    // Equal expiries stay in blocking order
+    while (iter != NULL && iter->delay_ticks <= ticks) {
+        ticks -= iter->delay_ticks;
+        prev = iter;
+        iter = iter->next;
+    }
+
+    tcb->delay_ticks = ticks;
+    tcb->prev = prev;
+    tcb->next = iter;
+    if (prev != NULL) {
+        prev->next = tcb;
+    } else {
+        g_timeout_head = tcb;
+    }
+    if (iter != NULL) {
+        iter->prev = tcb;
+        iter->delay_ticks -= ticks;
     }
-    g_blocked_head = tcb;
 }
 
-static void blocked_remove(task_tcb_t *tcb)
+static void timeout_remove(task_tcb_t *tcb)
 {
+    if (tcb->prev == NULL && g_timeout_head != tcb) {
+        return;
+    }
+
     if (tcb->prev != NULL) {
         tcb->prev->next = tcb->next;
-    } else if (g_blocked_head == tcb) {
-        g_blocked_head = tcb->next;
+    } else {
+        g_timeout_head = tcb->next;
     }
     if (tcb->next != NULL) {
         tcb->next->prev = tcb->prev;
+        tcb->next->delay_ticks += tcb->delay_ticks;
     }
     tcb->next = NULL;
     tcb->prev = NULL;
+    tcb->delay_ticks = 0;
+}
+
+// Insert behind the last waiter of equal or better priority
+static void wait_insert(task_tcb_t *tcb, task_tcb_t **head, task_tcb_t **tail)
+{
+    task_tcb_t *iter = *tail;
+
+    while (iter != NULL && iter->priority > tcb->priority) {
+        iter = iter->wait_prev;
+    }
+
+    tcb->wait_head = head;
+    tcb->wait_tail = tail;
+    tcb->wait_prev = iter;
+    if (iter == NULL) {
+        tcb->wait_next = *head;
+        *head = tcb;
+    } else {
+        tcb->wait_next = iter->wait_next;
+        iter->wait_next = tcb;
+    }
+
+    if (tcb->wait_next != NULL) {
+        tcb->wait_next->wait_prev = tcb;
+    } else {
+        *tail = tcb;
+    }
+}
+
+static void wait_remove(task_tcb_t *tcb)
+{
+    if (tcb->wait_head == NULL) {
+        return;
+    }
+
+    if (tcb->wait_prev != NULL) {
+        tcb->wait_prev->wait_next = tcb->wait_next;
+    } else {
+        *tcb->wait_head = tcb->wait_next;
+    }
+    if (tcb->wait_next != NULL) {
+        tcb->wait_next->wait_prev = tcb->wait_prev;
+    } else {
+        *tcb->wait_tail = tcb->wait_prev;
+    }
+
+    tcb->wait_head = NULL;
+    tcb->wait_tail = NULL;
+    tcb->wait_next = NULL;
+    tcb->wait_prev = NULL;
+}
+
+// Move a blocked task back to its ready list (caller holds critical section)
+static void wake_task(task_tcb_t *tcb, int result)
+{
+    timeout_remove(tcb);
+    wait_remove(tcb);
+    if (tcb->block_reason == BLOCK_PERIOD) {
+        job_release(tcb);
+    }
+    tcb->state = TASK_STATE_READY;
+    tcb->block_reason = BLOCK_NONE;
+    tcb->block_result = result;
+    tcb->block_object = NULL;
+    tcb->block_timeout = 0;
+#if CONFIG_CPU_BUDGET
+    // A throttled task stays parked until its budget refills
+    if (tcb->budget_depleted && tcb->budget_policy == BUDGET_POLICY_SUSPEND) {
+        tcb->state = TASK_STATE_BLOCKED;
+        tcb->block_reason = BLOCK_BUDGET;
+        return;
+    }
+#endif
+    ready_insert_tail(tcb);
+}
+
+// Wake a task whose timeout ran out
+static void timeout_expire(task_tcb_t *tcb)
+{
+    void *object = tcb->block_object;
+    block_reason_t reason = tcb->block_reason;
+
+    wake_task(tcb, expiry_result(tcb));
+
+    // A mutex waiter that gave up no longer boosts the owner chain
+    if (reason == BLOCK_MUTEX) {
+        mutex_priority_update(((mutex_t *)object)->owner);
+    }
+}
+
+// Move a task to a new priority wherever it is queued (caller holds critical section)
+static void requeue_priority(task_tcb_t *tcb, uint8_t prio)
+{
+    if (tcb->state == TASK_STATE_READY || tcb->state == TASK_STATE_RUNNING) {
+        bool boost_running = (tcb == current_task && prio < tcb->priority);
+
+        ready_remove(tcb);
+        tcb->priority = prio;
+        // A boosted running task must not yield to peers at its new level
+        if (boost_running) {
+            ready_insert_head(tcb);
+        } else {
+            ready_insert_tail(tcb);
+        }
+    } else if (tcb->state == TASK_STATE_BLOCKED && tcb->wait_head != NULL) {
+        // Keep the waiter's position in its wait list consistent
+        task_tcb_t **head = tcb->wait_head;
+        task_tcb_t **tail = tcb->wait_tail;
+
+        wait_remove(tcb);
+        tcb->priority = prio;
+        wait_insert(tcb, head, tail);
+    } else {
+        tcb->priority = prio;
+    }
+}
+
+#if CONFIG_CPU_BUDGET
+// Start a new budget period if the current one has ended
+static void budget_refresh(task_tcb_t *tcb)
+{
+    uint32_t late;
+
+    if (deadline_before(g_tick_count, tcb->budget_replenish)) {
+        return;
+    }
+    late = g_tick_count - tcb->budget_replenish;
+    tcb->budget_replenish += tcb->budget_period * ((late / tcb->budget_period) + 1U);
+    tcb->budget_used = 0;
+}
+
+static void budget_overrun(task_tcb_t *tcb)
+{
+    tcb->budget_depleted = 1;
+    tcb->budget_overruns++;
+    tcb->budget_next = g_budget_depleted;
+    g_budget_depleted = tcb;
+
+    switch (tcb->budget_policy) {
+    case BUDGET_POLICY_DEMOTE:
+        // Caps mutex boosts too; a blocked waiter passes it down its chain
+        mutex_priority_update(tcb);
+        break;
+    case BUDGET_POLICY_SUSPEND:
+        // Blocked tasks are parked by wake_task() when they wake
+        if (tcb->state == TASK_STATE_READY || tcb->state == TASK_STATE_RUNNING) {
+            ready_remove(tcb);
+            tcb->state = TASK_STATE_BLOCKED;
+            tcb->block_reason = BLOCK_BUDGET;
+            scheduler_trigger_switch();
+        }
+        break;
+    default:
+        kernel_budget_overrun_hook(tcb);
+        break;
+    }
+}
+
+// Refill a depleted task and undo its overrun policy
+static void budget_restore(task_tcb_t *tcb)
+{
+    tcb->budget_depleted = 0;
+    tcb->budget_used = 0;
+
+    if (tcb->state == TASK_STATE_BLOCKED && tcb->block_reason == BLOCK_BUDGET) {
+        wake_task(tcb, KERNEL_OK);
+        if (preempts_current(tcb)) {
+            scheduler_trigger_switch();
+        }
+    } else if (tcb->budget_policy == BUDGET_POLICY_DEMOTE) {
+        // Back to base, or to whatever ceiling or inherited boost applies
+        mutex_priority_update(tcb);
+    }
+}
+
+static void budget_unlink(task_tcb_t *tcb)
+{
+    task_tcb_t **link = &g_budget_depleted;
+
+    while (*link != NULL) {
+        if (*link == tcb) {
+            *link = tcb->budget_next;
+            tcb->budget_next = NULL;
+            return;
+        }
+        link = &(*link)->budget_next;
+    }
+}
+
+// Refill every depleted task whose replenish tick has come
+static void budget_replenish_due(void)
+{
+    task_tcb_t **link = &g_budget_depleted;
+    task_tcb_t *tcb;
+
+    while (*link != NULL) {
+        tcb = *link;
+        if (deadline_before(g_tick_count, tcb->budget_replenish)) {
+            link = &tcb->budget_next;
+            continue;
+        }
+        *link = tcb->budget_next;
+        tcb->budget_next = NULL;
+        budget_refresh(tcb);
+        budget_restore(tcb);
+    }
+}
+#endif
+
+#if CONFIG_PREEMPT_THRESHOLD
+// A dispatched task runs at its threshold until it blocks or yields
+static void threshold_acquire(task_tcb_t *tcb)
+{
+    if (!(tcb->flags & TASK_FLAG_THRESHOLD)) {
+        tcb->flags |= TASK_FLAG_THRESHOLD;
+        // Head of the level: the task was already the one chosen to run
+        if (tcb->threshold < tcb->priority) {
+            ready_remove(tcb);
+            tcb->priority = tcb->threshold;
+            ready_insert_head(tcb);
+        }
+    }
+    if (tcb->flags & TASK_FLAG_STACK_DROPPED) {
+        tcb->flags &= (uint8_t)~TASK_FLAG_STACK_DROPPED;
+        task_job_restart(tcb);
+    }
+}
+
+static void threshold_release(task_tcb_t *tcb)
+{
+    if (tcb->flags & TASK_FLAG_THRESHOLD) {
+        tcb->flags &= (uint8_t)~TASK_FLAG_THRESHOLD;
+        mutex_priority_update(tcb);
+    }
+}
+
+#endif
+
+// Threshold holders and shared-stack jobs are not time-sliced
+static inline bool threshold_no_slice(const task_tcb_t *tcb)
+{
+#if CONFIG_PREEMPT_THRESHOLD
+    return (tcb->flags & TASK_FLAG_SHARED_STACK) ||
+           tcb->threshold < tcb->base_priority;
+#else
+    (void)tcb;
+    return false;
+#endif
+}
+
+#if CONFIG_TASK_STATS || CONFIG_CPU_BUDGET
+// Charge the running task for the cycles since the last accounting point
+static void account_current(uint32_t now)
+{
+    uint32_t delta = now - g_account_cycles;
+
+    g_account_cycles = now;
+    if (current_task == NULL) {
+        return;
+    }
+
+#if CONFIG_TASK_STATS
+    current_task->total_cycles += delta;
+#endif
+#if CONFIG_CPU_BUDGET
+    if (current_task->budget_cycles != 0U && !current_task->budget_depleted) {
+        budget_refresh(current_task);
+        current_task->budget_used += delta;
+        if (current_task->budget_used >= current_task->budget_cycles) {
+            budget_overrun(current_task);
+        }
+    }
+#endif
+}
+#endif
+
+#if CONFIG_PARTITIONS
+static void partition_activate(uint8_t partition)
+{
+    uint8_t from = g_sched.active_partition;
+
+    g_sched.active_partition = partition;
+    if (from != partition) {
+        partition_trace_record(from, partition);
+        scheduler_trigger_switch();
+    }
+}
+
+// Step the major frame by one tick, moving to the next window at its end
+static void partition_tick(void)
+{
+    if (g_windows == NULL) {
+        return;
+    }
+    if (g_window_left > 0U) {
+        g_window_left--;
+    }
+    if (g_window_left == 0U) {
+        g_window_index++;
+        if (g_window_index >= g_window_count) {
+            g_window_index = 0;
+        }
+        g_window_left = g_windows[g_window_index].ticks;
+        partition_activate(g_windows[g_window_index].partition);
+    }
 }
+#endif
 
 void scheduler_init(void)
 {
     uint32_t i;
-    g_sched.priority_bitmap = 0;
+    uint32_t p;
+
+    for (p = 0; p < SCHED_QUEUE_COUNT; p++) {
+        ready_queue_t *q = &g_sched.ready[p];
+
+        q->priority_bitmap.group = 0;
+        for (i = 0; i < PRIO_GROUP_COUNT; i++) {
+            q->priority_bitmap.words[i] = 0;
+        }
+        for (i = 0; i < CONFIG_MAX_PRIORITY; i++) {
+            q->ready_list[i] = NULL;
+            q->ready_tail[i] = NULL;
+        }
+    }
     g_sched.current = NULL;
     g_sched.lock_count = 0;
     g_sched.reschedule_pending = false;
-    for (i = 0; i < CONFIG_MAX_PRIORITY; i++) {
-        g_sched.ready_list[i] = NULL;
-    }
+#if CONFIG_PARTITIONS
+    g_sched.active_partition = PARTITION_SYSTEM;
+    g_windows = NULL;
+    g_window_count = 0;
+    g_window_index = 0;
+    g_window_left = 0;
+#endif
+#if CONFIG_EDF
+    g_sched.edf_count = 0;
+#endif
     g_tick_count = 0;
-    g_blocked_head = NULL;
+    g_timeout_head = NULL;
     current_task = NULL;
     next_task = NULL;
 }
@@ -85,6 +682,9 @@ void scheduler_init(void)
 void scheduler_start(void)
 {
     task_tcb_t *first;
+    const hw_stack_frame_t *frame;
+    void (*entry)(void *);
+    void *arg;
 
     first = scheduler_get_next();
     if (first == NULL) {
@@ -97,11 +697,28 @@ void scheduler_start(void)
      * Later switches use PendSV save/restore and EXC_RETURN.
      */
      
+#if CONFIG_PREEMPT_THRESHOLD
+    threshold_acquire(first);
+#endif
+
+    // Enter through the prepared frame: periodic and shared-stack tasks
+    // start in a kernel loop around the user entry
+    frame = (const hw_stack_frame_t *)(first->sp +
+                                       sizeof(sw_stack_frame_t) / sizeof(uint32_t));
+    entry = (void (*)(void *))(uintptr_t)frame->pc;
+    arg = (void *)(uintptr_t)frame->r0;
+
     current_task = first;
     g_sched.current = first;
     first->state = TASK_STATE_RUNNING;
     first->time_slice = CONFIG_TIME_SLICE;
     first->sp = first->stack_top;
+#if CONFIG_TASK_STATS
+    first->run_count++;
+#endif
+#if CONFIG_TASK_STATS || CONFIG_CPU_BUDGET
+    g_account_cycles = DWT_CYCCNT;
+#endif
 
     __asm volatile (
         "msr psp, %0      \n"
@@ -114,7 +731,7 @@ void scheduler_start(void)
         : "r1", "memory"
     );
 
-    first->entry(first->arg);
+    entry(arg);
     (void)task_delete(NULL);
     while (1) { __asm volatile ("wfi"); }
 }
@@ -127,7 +744,7 @@ void scheduler_add_task(task_tcb_t *tcb)
     tcb->time_slice = CONFIG_TIME_SLICE;
     ready_insert_tail(tcb);
 
-    if (current_task != NULL && tcb->priority < current_task->priority) {
+    if (preempts_current(tcb)) {
         scheduler_trigger_switch();
     }
 
@@ -136,8 +753,6 @@ void scheduler_add_task(task_tcb_t *tcb)
 
 void scheduler_remove_task(task_tcb_t *tcb)
 {
-    task_tcb_t *head;
-    uint8_t prio;
     uint32_t irq_state = critical_enter();
 
     if (tcb == NULL) {
@@ -145,42 +760,69 @@ void scheduler_remove_task(task_tcb_t *tcb)
         return;
     }
 
-    prio = tcb->priority;
-    head = g_sched.ready_list[prio];
-
-    if (head == tcb) {
-        g_sched.ready_list[prio] = tcb->next;
-    }
-    if (tcb->prev != NULL) {
-        tcb->prev->next = tcb->next;
+    if (tcb->state == TASK_STATE_BLOCKED) {
+        timeout_remove(tcb);
+        wait_remove(tcb);
+        // A waiter leaving the queue no longer boosts the owner chain
+        if (tcb->block_reason == BLOCK_MUTEX) {
+            mutex_priority_update(((mutex_t *)tcb->block_object)->owner);
+        }
+#if CONFIG_HRTIMER
+        // The sleep timer is on the task's stack
+        if (tcb->block_reason == BLOCK_HRTIMER) {
+            (void)hrtimer_stop((hrtimer_t *)tcb->block_object);
+        }
+#endif
+        // The wait was not satisfied: the interrupted call fails once the
+        // task runs again, and a periodic task still gets its next job
+        if (tcb->block_reason == BLOCK_PERIOD) {
+            job_release(tcb);
+        }
+        tcb->block_reason = BLOCK_NONE;
+        tcb->block_result = KERNEL_ERR_STATE;
+        tcb->block_object = NULL;
+        tcb->block_timeout = 0;
+    } else {
+#if CONFIG_PREEMPT_THRESHOLD
+        threshold_release(tcb);
+#endif
+        ready_remove(tcb);
     }
-    if (tcb->next != NULL) {
-        tcb->next->prev = tcb->prev;
+#if CONFIG_PREEMPT_THRESHOLD
+    // A shared-stack job loses its frame and restarts when resumed
+    if (tcb->flags & TASK_FLAG_SHARED_STACK) {
+        tcb->flags |= TASK_FLAG_STACK_DROPPED;
     }
+#endif
 
-    if (g_sched.ready_list[prio] == NULL) {
-        bitmap_clear(&g_sched.priority_bitmap, prio);
+#if CONFIG_CPU_BUDGET
+    // Leaving the scheduler forfeits the overrun state
+    if (tcb->budget_depleted) {
+        budget_unlink(tcb);
+        tcb->budget_depleted = 0;
+        // Off every queue here, so only the field needs updating
+        tcb->priority = mutex_effective_priority(tcb);
     }
-
-    tcb->next = NULL;
-    tcb->prev = NULL;
+#endif
 
     critical_exit(irq_state);
 }
 
 void scheduler_set_priority(task_tcb_t *tcb, uint8_t new_priority)
 {
-    if (tcb == NULL || new_priority >= CONFIG_MAX_PRIORITY) {
+    uint32_t irq_state;
+
+    if (tcb == NULL || !priority_valid(new_priority)) {
         return;
     }
 
-    if (tcb->state == TASK_STATE_READY || tcb->state == TASK_STATE_RUNNING) {
-        scheduler_remove_task(tcb);
-        tcb->priority = new_priority;
-        scheduler_add_task(tcb);
-    } else {
-        tcb->priority = new_priority;
+    irq_state = critical_enter();
+    requeue_priority(tcb, new_priority);
+    if ((tcb->state == TASK_STATE_READY || tcb->state == TASK_STATE_RUNNING) &&
+        scheduler_get_next() != current_task) {
+        scheduler_trigger_switch();
     }
+    critical_exit(irq_state);
 }
 
 void scheduler_yield(void)
@@ -200,16 +842,23 @@ void scheduler_yield(void)
         return;
     }
 
+#if CONFIG_PREEMPT_THRESHOLD
+    // Letting a group peer in would reuse the stack of the running job
+    if ((current_task->flags & TASK_FLAG_SHARED_STACK) &&
+        (current_task->state == TASK_STATE_READY ||
+         current_task->state == TASK_STATE_RUNNING)) {
+        critical_exit(irq_state);
+        return;
+    }
+    threshold_release(current_task);
+#endif
+
     prio = current_task->priority;
-    head = g_sched.ready_list[prio];
+    head = task_queue(current_task)->ready_list[prio];
 
     // Round-robin: move head to tail when peers exist at same priority
     if (head != NULL && head->next != NULL && head == current_task) {
-        g_sched.ready_list[prio] = head->next;
-        g_sched.ready_list[prio]->prev = NULL;
-
-        head->next = NULL;
-        head->prev = NULL;
+        ready_remove(head);
         ready_insert_tail(head);
     }
 
@@ -219,39 +868,31 @@ void scheduler_yield(void)
 
 void scheduler_tick(void)
 {
-    task_tcb_t *iter;
-    task_tcb_t *next_iter;
-    uint8_t highest_prio;
+    task_tcb_t *expired;
+    task_tcb_t *next;
     uint32_t irq_state = critical_enter();
 
     g_tick_count++;
 
-    iter = g_blocked_head;
-    while (iter != NULL) {
-        bool wake = false;
-        next_iter = iter->next;
-
-        if (iter->block_reason == BLOCK_DELAY) {
-            if (g_tick_count >= iter->wake_tick) {
-                wake = true;
-            }
-        } else if (iter->block_timeout != 0U && iter->block_timeout != UINT32_MAX) {
-            if (g_tick_count >= iter->wake_tick) {
-                iter->block_result = KERNEL_ERR_TIMEOUT;
-                wake = true;
-            }
-        }
-
-        if (wake) {
-            blocked_remove(iter);
-            iter->block_reason = BLOCK_NONE;
-            iter->block_object = NULL;
-            iter->block_timeout = 0;
-            iter->state = TASK_STATE_READY;
-            ready_insert_tail(iter);
-        }
+#if CONFIG_TASK_STATS || CONFIG_CPU_BUDGET
+    account_current(DWT_CYCCNT);
+#endif
+#if CONFIG_TASK_STATS
+    if (current_task != NULL) {
+        current_task->total_ticks++;
+    }
+#endif
+#if CONFIG_CPU_BUDGET
+    budget_replenish_due();
+#endif
 
-        iter = next_iter;
+    // Only the head is aged; everything behind it is relative
+    if (g_timeout_head != NULL && g_timeout_head->delay_ticks > 0U) {
+        g_timeout_head->delay_ticks--;
+    }
+    while (g_timeout_head != NULL && g_timeout_head->delay_ticks == 0U) {
+        expired = g_timeout_head;
+        timeout_expire(expired);
     }
 
     if (current_task != NULL) {
@@ -260,57 +901,258 @@ void scheduler_tick(void)
         }
         if (CONFIG_ROUND_ROBIN && current_task->time_slice == 0U) {
             current_task->time_slice = CONFIG_TIME_SLICE;
-            scheduler_yield();
+            if (!threshold_no_slice(current_task)) {
+                scheduler_yield();
+            }
         }
     }
 
-    highest_prio = bitmap_find_highest(g_sched.priority_bitmap);
-    if (current_task != NULL && highest_prio < current_task->priority) {
+#if CONFIG_PARTITIONS
+    partition_tick();
+#endif
+
+    next = scheduler_get_next();
+    if (next != NULL && next != current_task && preempts_current(next)) {
         scheduler_trigger_switch();
     }
 
     critical_exit(irq_state);
 }
 
-int scheduler_block_task(block_reason_t reason, void *object, uint32_t timeout)
+#if CONFIG_TICKLESS_IDLE
+uint32_t scheduler_next_wake_ticks(void)
+{
+    // A runnable peer of the caller still needs the tick for round-robin
+    if (current_task == NULL || current_task->next != NULL ||
+        scheduler_get_next() != current_task) {
+        return 0;
+    }
+#if CONFIG_PARTITIONS
+    // The tick has to be running to end the current window
+    if (g_windows != NULL &&
+        (g_timeout_head == NULL || g_window_left < g_timeout_head->delay_ticks)) {
+        return g_window_left;
+    }
+#endif
+    if (g_timeout_head == NULL) {
+        return UINT32_MAX;
+    }
+    return g_timeout_head->delay_ticks;
+}
+
+void scheduler_advance_ticks(uint32_t ticks)
+{
+    task_tcb_t *expired;
+    uint32_t irq_state = critical_enter();
+
+    g_tick_count += ticks;
+
+#if CONFIG_PARTITIONS
+    // Like the timers, a window never ends here but on the next real tick
+    if (g_windows != NULL) {
+        g_window_left = (g_window_left > ticks) ? (g_window_left - ticks) : 1U;
+    }
+#endif
+
+    /*
+     * Callers step less than scheduler_next_wake_ticks(), so normally
+     * only the head delta shrinks; anything that does reach zero is
+     * woken exactly as scheduler_tick() would.
+     */
+    while (ticks > 0U && g_timeout_head != NULL) {
+        if (g_timeout_head->delay_ticks > ticks) {
+            g_timeout_head->delay_ticks -= ticks;
+            break;
+        }
+        ticks -= g_timeout_head->delay_ticks;
+        g_timeout_head->delay_ticks = 0;
+        while (g_timeout_head != NULL && g_timeout_head->delay_ticks == 0U) {
+            expired = g_timeout_head;
+            timeout_expire(expired);
+            scheduler_trigger_switch();
+        }
+    }
+
+    critical_exit(irq_state);
+}
+#endif
+
+// Overran into the next period: release the next job without blocking
+static void period_release_now(task_tcb_t *self)
+{
+    ready_remove(self);
+    job_release(self);
+    ready_insert_tail(self);
+    if (scheduler_get_next() != self) {
+        scheduler_trigger_switch();
+    }
+}
+
+/*
+ * block_recheck - Re-test a wait condition inside the blocking section
+ * @reason: Why the caller is about to block
+ * @object: Object it blocks on
+ *
+ * Returns: true if the object became available after the caller's own
+ * check, so blocking now would sleep on a free object.
+ */
+static bool block_recheck(block_reason_t reason, void *object)
+{
+    const msg_queue_t *queue = (const msg_queue_t *)object;
+    uint32_t flags;
+    uint32_t bits;
+
+    switch (reason) {
+    case BLOCK_SEMAPHORE:
+        return ((semaphore_t *)object)->count > 0;
+    case BLOCK_QUEUE_SEND:
+        return queue->count < queue->capacity;
+    case BLOCK_QUEUE_RECV:
+        return queue->count > 0U;
+    case BLOCK_EVENT:
+        flags = ((event_group_t *)object)->flags;
+        bits = current_task->event_wait_bits;
+        if (current_task->event_wait_all) {
+            return (flags & bits) == bits;
+        }
+        return (flags & bits) != 0U;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Common block path. With @until set, @timeout is an absolute wake tick
+ * and is converted under the same critical section that blocks.
+ */
+static int block_current(block_reason_t reason, void *object,
+                         task_tcb_t **wait_head, task_tcb_t **wait_tail,
+                         uint32_t timeout, bool until)
 {
     task_tcb_t *self;
     uint32_t irq_state = critical_enter();
 
-    if (current_task == NULL) {
+    /*
+     * Blocking needs PendSV to run right after the critical section;
+     * with the scheduler locked or interrupts already masked by the
+     * caller it could not, and the task would return still blocked.
+     */
+    if (current_task == NULL || g_sched.lock_count > 0U || irq_state != 0U) {
+        critical_exit(irq_state);
+        return KERNEL_ERR_STATE;
+    }
+
+    if (until) {
+        timeout -= g_tick_count;
+        if (timeout == 0U || (int32_t)timeout < 0) {
+            // A release that is already due still has to start its job
+            if (reason == BLOCK_PERIOD) {
+                period_release_now(current_task);
+                critical_exit(irq_state);
+                return KERNEL_OK;
+            }
+            critical_exit(irq_state);
+            return (timeout == 0U) ? KERNEL_OK : KERNEL_ERR_TIMEOUT;
+        }
+    }
+
+#if CONFIG_TASK_NOTIFY
+    // A notification sent after the caller's own check cancels the block
+    if ((reason == BLOCK_NOTIFY || reason == BLOCK_JOB) &&
+        current_task->notify_pending) {
+        critical_exit(irq_state);
+        return KERNEL_OK;
+    }
+#endif
+    // The owner unlocked between mutex_trylock() and here: retry the lock
+    if (reason == BLOCK_MUTEX && ((mutex_t *)object)->owner == NULL) {
+        critical_exit(irq_state);
+        return KERNEL_OK;
+    }
+    // Likewise a give, send, receive or set that landed after the
+    // caller's own check: block_recheck() sends it round its loop again
+    if (block_recheck(reason, object)) {
+        critical_exit(irq_state);
+        return KERNEL_OK;
+    }
+#if CONFIG_HRTIMER
+    // The sleep timer fired between hrtimer_start() and here
+    if (reason == BLOCK_HRTIMER && !hrtimer_is_active((hrtimer_t *)object)) {
+        critical_exit(irq_state);
+        return KERNEL_OK;
+    }
+#endif
+#if CONFIG_PREEMPT_THRESHOLD
+    // The group stack is only free between jobs
+    if ((current_task->flags & TASK_FLAG_SHARED_STACK) && reason != BLOCK_JOB) {
         critical_exit(irq_state);
         return KERNEL_ERR_STATE;
     }
+#endif
 
     self = current_task;
-    scheduler_remove_task(current_task);
+    ready_remove(current_task);
     current_task->state = TASK_STATE_BLOCKED;
     current_task->block_reason = reason;
     current_task->block_object = object;
     current_task->block_timeout = timeout;
     current_task->block_result = KERNEL_OK;
-    if (timeout == 0U) {
-        current_task->wake_tick = g_tick_count + 1U;
-    } else if (timeout == UINT32_MAX) {
-        current_task->wake_tick = UINT32_MAX;
-    } else {
-        current_task->wake_tick = g_tick_count + timeout;
+#if CONFIG_PREEMPT_THRESHOLD
+    if (reason == BLOCK_JOB) {
+        current_task->flags |= TASK_FLAG_STACK_DROPPED;
     }
+#endif
 
-    blocked_insert(current_task);
+    // A zero timeout means one tick for delays and no timeout otherwise
+    if (timeout == 0U && reason == BLOCK_DELAY) {
+        timeout = 1U;
+    }
+    if (timeout != 0U && timeout != UINT32_MAX) {
+        current_task->wake_tick = g_tick_count + timeout;
+        timeout_insert(current_task, timeout);
+    }
+    if (wait_head != NULL) {
+        wait_insert(current_task, wait_head, wait_tail);
+    }
+#if CONFIG_PREEMPT_THRESHOLD
+    // Wait at the task's own priority; a mutex owner boosted to the
+    // threshold settles back to it through the chain update
+    threshold_release(current_task);
+#endif
+    // Boost only once queued, so no chain update can miss this waiter
+    if (reason == BLOCK_MUTEX) {
+        mutex_priority_update(((mutex_t *)object)->owner);
+    }
     scheduler_trigger_switch();
+    __DSB();
     critical_exit(irq_state);
 
-
     /*
-     * Force a switch point; this function resumes only when 'self'
-     * is scheduled again and can then return the unblock result.
+     * The pended PendSV is taken as soon as PRIMASK clears; the ISB
+     * keeps the load below from being issued ahead of it. Execution
+     * continues here only once 'self' has been woken and rescheduled.
      */
-     
-    scheduler_yield();
+    __ISB();
     return self->block_result;
 }
 
+int scheduler_block_task(block_reason_t reason, void *object, uint32_t timeout)
+{
+    return block_current(reason, object, NULL, NULL, timeout, false);
+}
+
+int scheduler_block_on(block_reason_t reason, void *object,
+                       task_tcb_t **wait_head, task_tcb_t **wait_tail,
+                       uint32_t timeout)
+{
+    return block_current(reason, object, wait_head, wait_tail, timeout, false);
+}
+
+int scheduler_block_until(block_reason_t reason, uint32_t wake_tick)
+{
+    return block_current(reason, NULL, NULL, NULL, wake_tick, true);
+}
+
 void scheduler_unblock_task(task_tcb_t *tcb, int result)
 {
     uint32_t irq_state = critical_enter();
@@ -320,77 +1162,44 @@ void scheduler_unblock_task(task_tcb_t *tcb, int result)
         return;
     }
 
-    blocked_remove(tcb);
-    tcb->state = TASK_STATE_READY;
-    tcb->block_reason = BLOCK_NONE;
-    tcb->block_result = result;
-    tcb->block_object = NULL;
-    tcb->block_timeout = 0;
-    ready_insert_tail(tcb);
+    wake_task(tcb, result);
 
-    if (current_task != NULL && tcb->priority < current_task->priority) {
+    if (preempts_current(tcb)) {
         scheduler_trigger_switch();
     }
 
     critical_exit(irq_state);
 }
 
-bool scheduler_unblock_one(block_reason_t reason, void *object, int result)
+bool scheduler_unblock_one(task_tcb_t **wait_head, int result)
 {
-    task_tcb_t *iter;
-    task_tcb_t *best = NULL;
+    task_tcb_t *best;
     uint32_t irq_state = critical_enter();
 
-    iter = g_blocked_head;
-    while (iter != NULL) {
-        if (iter->block_reason == reason && iter->block_object == object) {
-            if (best == NULL || iter->priority < best->priority) {
-                best = iter;
-            }
-        }
-        iter = iter->next;
+    // Wait lists are priority sorted: the head is the best waiter
+    best = *wait_head;
+    if (best == NULL) {
+        critical_exit(irq_state);
+        return false;
     }
 
-    if (best != NULL) {
-        blocked_remove(best);
-        best->state = TASK_STATE_READY;
-        best->block_reason = BLOCK_NONE;
-        best->block_result = result;
-        best->block_object = NULL;
-        best->block_timeout = 0;
-        ready_insert_tail(best);
-        if (current_task != NULL && best->priority < current_task->priority) {
-            scheduler_trigger_switch();
-        }
-        critical_exit(irq_state);
-        return true;
+    wake_task(best, result);
+    if (preempts_current(best)) {
+        scheduler_trigger_switch();
     }
 
     critical_exit(irq_state);
-    return false;
+    return true;
 }
 
-uint32_t scheduler_unblock_all(block_reason_t reason, void *object, int result)
+uint32_t scheduler_unblock_all(task_tcb_t **wait_head, int result)
 {
-    task_tcb_t *iter;
-    task_tcb_t *next_iter;
     uint32_t unblocked = 0;
     uint32_t irq_state = critical_enter();
 
-    iter = g_blocked_head;
-    while (iter != NULL) {
-        next_iter = iter->next;
-        if (iter->block_reason == reason && iter->block_object == object) {
-            blocked_remove(iter);
-            iter->state = TASK_STATE_READY;
-            iter->block_reason = BLOCK_NONE;
-            iter->block_result = result;
-            iter->block_object = NULL;
-            iter->block_timeout = 0;
-            ready_insert_tail(iter);
-            unblocked++;
-        }
-        iter = next_iter;
+    while (*wait_head != NULL) {
+        wake_task(*wait_head, result);
+        unblocked++;
     }
 
     if (unblocked > 0U) {
@@ -401,23 +1210,199 @@ uint32_t scheduler_unblock_all(block_reason_t reason, void *object, int result)
     return unblocked;
 }
 
+void scheduler_set_deadline(task_tcb_t *tcb, uint32_t period, uint32_t rel_deadline)
+{
+    bool queued;
+    uint32_t irq_state = critical_enter();
+
+    queued = (tcb->state == TASK_STATE_READY || tcb->state == TASK_STATE_RUNNING);
+    if (queued) {
+        ready_remove(tcb);
+    }
+
+    tcb->period = period;
+    tcb->rel_deadline = rel_deadline;
+    tcb->release_tick = g_tick_count;
+    tcb->deadline = g_tick_count + rel_deadline;
+#if CONFIG_EDF
+    tcb->flags |= TASK_FLAG_EDF;
+    tcb->base_priority = CONFIG_EDF_PRIORITY;
+    if (tcb->state == TASK_STATE_BLOCKED && tcb->wait_head != NULL) {
+        task_tcb_t **head = tcb->wait_head;
+        task_tcb_t **tail = tcb->wait_tail;
+
+        wait_remove(tcb);
+        tcb->priority = CONFIG_EDF_PRIORITY;
+        wait_insert(tcb, head, tail);
+    } else {
+        tcb->priority = CONFIG_EDF_PRIORITY;
+    }
+#endif
+
+    if (queued) {
+        ready_insert_tail(tcb);
+        if (scheduler_get_next() != current_task) {
+            scheduler_trigger_switch();
+        }
+    }
+
+    critical_exit(irq_state);
+}
+
+int scheduler_wait_next_period(void)
+{
+    task_tcb_t *self;
+    uint32_t next_release;
+    int result = KERNEL_OK;
+    int res;
+    uint32_t irq_state = critical_enter();
+
+    self = current_task;
+    if (self == NULL || self->period == 0U) {
+        critical_exit(irq_state);
+        return KERNEL_ERR_PARAM;
+    }
+
+    if (deadline_before(self->deadline, g_tick_count)) {
+        self->deadline_misses++;
+        result = KERNEL_ERR_TIMEOUT;
+    }
+
+    next_release = self->release_tick + self->period;
+    if (!deadline_before(g_tick_count, next_release)) {
+        period_release_now(self);
+        critical_exit(irq_state);
+        return result;
+    }
+    critical_exit(irq_state);
+
+    /*
+     * Absolute wake tick: the remaining time is taken under the blocking
+     * critical section, and a release reached meanwhile is started there.
+     * The wake path re-arms release_tick and deadline (see wake_task).
+     */
+    res = scheduler_block_until(BLOCK_PERIOD, next_release);
+    return (res != KERNEL_OK) ? res : result;
+}
+
+#if CONFIG_PARTITIONS
+void scheduler_set_partition_table(const partition_window_t *windows, uint32_t count)
+{
+    uint32_t irq_state = critical_enter();
+
+    g_windows = windows;
+    g_window_count = count;
+    g_window_index = 0;
+    g_window_left = windows[0].ticks;
+    partition_activate(windows[0].partition);
+
+    critical_exit(irq_state);
+}
+
+void scheduler_set_task_partition(task_tcb_t *tcb, uint8_t partition)
+{
+    uint32_t irq_state = critical_enter();
+
+    if (tcb->state == TASK_STATE_READY || tcb->state == TASK_STATE_RUNNING) {
+        ready_remove(tcb);
+        tcb->partition = partition;
+        ready_insert_tail(tcb);
+    } else {
+        tcb->partition = partition;
+    }
+    if (current_task != NULL && scheduler_get_next() != current_task) {
+        scheduler_trigger_switch();
+    }
+
+    critical_exit(irq_state);
+}
+
+uint8_t scheduler_get_partition(void)
+{
+    return g_sched.active_partition;
+}
+#endif
+
+#if CONFIG_CPU_BUDGET
+void scheduler_set_budget(task_tcb_t *tcb, uint32_t cycles, uint32_t period, uint8_t policy)
+{
+    uint32_t irq_state = critical_enter();
+
+    // Undo any overrun state of the previous budget first
+    if (tcb->budget_depleted) {
+        budget_unlink(tcb);
+        budget_restore(tcb);
+    }
+
+    tcb->budget_cycles = cycles;
+    tcb->budget_period = period;
+    tcb->budget_policy = policy;
+    tcb->budget_used = 0;
+    tcb->budget_replenish = g_tick_count + period;
+
+    critical_exit(irq_state);
+}
+#endif
+
 task_tcb_t *scheduler_get_current(void)
 {
     return current_task;
 }
 
-task_tcb_t *scheduler_get_next(void)
+static task_tcb_t *queue_get_next(const ready_queue_t *q)
 {
-    uint8_t highest_prio = bitmap_find_highest(g_sched.priority_bitmap);
+    uint32_t highest_prio = bitmap_find_highest(&q->priority_bitmap);
     if (highest_prio >= CONFIG_MAX_PRIORITY) {
         return NULL;
     }
-    return g_sched.ready_list[highest_prio];
+#if CONFIG_EDF
+    // Plain FIFO tasks at the EDF level run ahead of the deadline heap
+    if (highest_prio == CONFIG_EDF_PRIORITY &&
+        q->ready_list[highest_prio] == NULL) {
+        return g_sched.edf_heap[0];
+    }
+#endif
+    return q->ready_list[highest_prio];
+}
+
+task_tcb_t *scheduler_get_next(void)
+{
+#if CONFIG_PARTITIONS
+    task_tcb_t *best = queue_get_next(&g_sched.ready[g_sched.active_partition]);
+    task_tcb_t *sys;
+
+    // The system partition competes by priority inside every window
+    if (g_sched.active_partition != PARTITION_SYSTEM) {
+        sys = queue_get_next(&g_sched.ready[PARTITION_SYSTEM]);
+        if (sys != NULL && (best == NULL || sys->priority < best->priority)) {
+            best = sys;
+        }
+    }
+    return best;
+#else
+    return queue_get_next(&g_sched.ready[0]);
+#endif
 }
 
-task_tcb_t *scheduler_select_next_task(void)
+task_tcb_t *scheduler_select_next_task(uint32_t cycles)
 {
+#if CONFIG_TASK_STATS || CONFIG_CPU_BUDGET
+    account_current(cycles);
+#else
+    (void)cycles;
+#endif
+
     next_task = scheduler_get_next();
+#if CONFIG_PREEMPT_THRESHOLD
+    if (next_task != NULL) {
+        threshold_acquire(next_task);
+    }
+#endif
+#if CONFIG_TASK_STATS
+    if (next_task != NULL && next_task != current_task) {
+        next_task->run_count++;
+    }
+#endif
     g_sched.current = next_task;
     return next_task;
 }
@@ -455,11 +1440,14 @@ bool scheduler_is_locked(void)
 }
 
 // SysTick is owned by the scheduler when kernel is running 
+#if !CONFIG_CYCLIC_EXECUTIVE
 void SysTick_Handler(void)
 {
+    kernel_time_tick();
     scheduler_tick();
 #if CONFIG_SW_TIMERS
     timer_tick_isr();
 #endif
     kernel_tick_hook();
 }
+#endif
@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "task.h"
+#include "partition.h"
 
 // Scheduler Configuration
 
@@ -27,6 +28,78 @@
 #define CONFIG_ROUND_ROBIN      1
 #endif
 
+#if CONFIG_MAX_PRIORITY > 256
+#error "CONFIG_MAX_PRIORITY must not exceed 256"
+#endif
+
+#ifndef CONFIG_EDF
+#define CONFIG_EDF              0
+#endif
+
+#ifndef CONFIG_EDF_PRIORITY
+#define CONFIG_EDF_PRIORITY     8
+#endif
+
+#ifndef CONFIG_EDF_MAX_TASKS
+#define CONFIG_EDF_MAX_TASKS    16
+#endif
+
+#ifndef CONFIG_PARTITIONS
+#define CONFIG_PARTITIONS       0
+#endif
+
+#ifndef CONFIG_PARTITION_COUNT
+#define CONFIG_PARTITION_COUNT  4
+#endif
+
+#ifndef CONFIG_PARTITION_TRACE_DEPTH
+#define CONFIG_PARTITION_TRACE_DEPTH 16
+#endif
+
+#ifndef CONFIG_PREEMPT_THRESHOLD
+#define CONFIG_PREEMPT_THRESHOLD 0
+#endif
+
+#if CONFIG_PREEMPT_THRESHOLD && !CONFIG_TASK_NOTIFY
+#error "CONFIG_PREEMPT_THRESHOLD needs CONFIG_TASK_NOTIFY (shared-stack jobs are released by notification)"
+#endif
+
+#ifndef CONFIG_CYCLIC_EXECUTIVE
+#define CONFIG_CYCLIC_EXECUTIVE 0
+#endif
+
+#if CONFIG_CYCLIC_EXECUTIVE && (CONFIG_EDF || CONFIG_PARTITIONS)
+#error "CONFIG_CYCLIC_EXECUTIVE replaces the scheduler: disable EDF and partitions"
+#endif
+
+#if CONFIG_PARTITIONS
+#if CONFIG_EDF
+#error "CONFIG_EDF and CONFIG_PARTITIONS cannot be combined"
+#endif
+#if CONFIG_PARTITION_COUNT < 2 || CONFIG_PARTITION_COUNT > 256
+#error "CONFIG_PARTITION_COUNT must be 2..256"
+#endif
+#define SCHED_QUEUE_COUNT       CONFIG_PARTITION_COUNT
+#else
+#define SCHED_QUEUE_COUNT       1
+#endif
+
+/*
+ * Two-level Priority Bitmap
+ *
+ * Priorities are split into groups of 32. Bit G of 'group' is set when
+ * words[G] is non-zero, and bit N of words[G] stands for priority
+ * G * 32 + N. Finding the highest ready priority is two CTZ operations
+ * regardless of CONFIG_MAX_PRIORITY (up to 256).
+ */
+
+#define PRIO_GROUP_COUNT    ((CONFIG_MAX_PRIORITY + 31) / 32)
+
+typedef struct {
+    uint32_t group;
+    uint32_t words[PRIO_GROUP_COUNT];
+} prio_bitmap_t;
+
 /* 
  * Ready Queue Structure
  * 
@@ -36,11 +109,30 @@
 
 
 typedef struct {
-    /* Bitmap: bit N set = priority N has ready tasks */
-    uint32_t priority_bitmap;
+    /* Bitmap: priority N set = priority N has ready tasks */
+    prio_bitmap_t priority_bitmap;
     
     /* Head of ready list for each priority */
     task_tcb_t *ready_list[CONFIG_MAX_PRIORITY];
+
+    /* Tail of ready list for each priority (O(1) append/rotate) */
+    task_tcb_t *ready_tail[CONFIG_MAX_PRIORITY];
+} ready_queue_t;
+
+typedef struct {
+    /* One ready queue per partition (just one without partitions) */
+    ready_queue_t ready[SCHED_QUEUE_COUNT];
+
+#if CONFIG_PARTITIONS
+    /* Partition owning the current major-frame window */
+    uint8_t active_partition;
+#endif
+
+#if CONFIG_EDF
+    /* Ready EDF tasks at CONFIG_EDF_PRIORITY, min-heap on deadline */
+    task_tcb_t *edf_heap[CONFIG_EDF_MAX_TASKS];
+    uint32_t edf_count;
+#endif
     
     /* Currently running task */
     task_tcb_t *current;
@@ -114,6 +206,25 @@ void scheduler_yield(void);
  
 void scheduler_tick(void);
 
+#if CONFIG_TICKLESS_IDLE
+/*
+ * scheduler_next_wake_ticks - Ticks the scheduler can go without a tick
+ *
+ * Returns: Ticks until the earliest timeout expires, 0 if the caller
+ *          has runnable peers, UINT32_MAX if nothing is pending
+ */
+
+uint32_t scheduler_next_wake_ticks(void);
+
+/*
+ * scheduler_advance_ticks - Credit ticks skipped while tickless
+ *
+ * @ticks: Number of tick periods that elapsed without an interrupt
+ */
+
+void scheduler_advance_ticks(uint32_t ticks);
+#endif
+
 /*
  * scheduler_block_task - Block current task
  * 
@@ -121,10 +232,53 @@ void scheduler_tick(void);
  * @object:  Object blocking on (can be NULL)
  * @timeout: Timeout in ticks (0 = infinite)
  * 
- * Returns: Block result (KERNEL_OK, KERNEL_ERR_TIMEOUT, etc.)
+ * Costs exactly one context switch: the task leaves the ready queue and
+ * PendSV is pended inside one critical section, and the call returns
+ * when the task has been woken and scheduled again.
+ *
+ * Returns: Block result (KERNEL_OK, KERNEL_ERR_TIMEOUT, etc.), or
+ *          KERNEL_ERR_STATE if called with the scheduler locked or
+ *          with interrupts masked
  */
 int scheduler_block_task(block_reason_t reason, void *object, uint32_t timeout);
 
+/*
+ * scheduler_block_on - Block current task on an object's wait list
+ *
+ * Same as scheduler_block_task(), but also queues the task on the
+ * object's wait list in priority order (FIFO among equal priorities).
+ *
+ * @reason:    Why task is blocking
+ * @object:    Object blocking on
+ * @wait_head: Head pointer of the object's wait list
+ * @wait_tail: Tail pointer of the object's wait list
+ * @timeout:   Timeout in ticks (UINT32_MAX = infinite)
+ *
+ * Returns: Block result (KERNEL_OK, KERNEL_ERR_TIMEOUT, etc.)
+ */
+
+int scheduler_block_on(block_reason_t reason, void *object,
+                       task_tcb_t **wait_head, task_tcb_t **wait_tail,
+                       uint32_t timeout);
+
+/*
+ * scheduler_block_until - Block current task until an absolute tick
+ *
+ * The remaining ticks are taken from the tick count inside the same
+ * critical section that blocks, so a tick arriving during the call
+ * cannot shift the wakeup.
+ *
+ * @reason:    Why task is blocking (expires with KERNEL_OK only for
+ *             BLOCK_DELAY and BLOCK_PERIOD)
+ * @wake_tick: Tick to wake at
+ *
+ * Returns: KERNEL_OK once woken, or at once if @wake_tick is now;
+ *          KERNEL_ERR_TIMEOUT without blocking if it is already past;
+ *          KERNEL_ERR_STATE as scheduler_block_task()
+ */
+
+int scheduler_block_until(block_reason_t reason, uint32_t wake_tick);
+
 /*
  * scheduler_unblock_task - Unblock a blocked task
  * 
@@ -135,24 +289,80 @@ int scheduler_block_task(block_reason_t reason, void *object, uint32_t timeout);
 void scheduler_unblock_task(task_tcb_t *tcb, int result);
 
 /*
- * scheduler_unblock_one - Wake highest-priority task blocked on object/reason
+ * scheduler_unblock_one - Wake highest-priority waiter of a wait list
+ *
+ * The list is kept sorted, so this is O(1).
  *
- * @reason: Block reason to match
- * @object: Object pointer used in scheduler_block_task()
- * @result: Result code for resumed task
+ * @wait_head: Head pointer of the object's wait list
+ * @result:    Result code for resumed task
  *
  * Returns: true if a task was unblocked
  */
- 
-bool scheduler_unblock_one(block_reason_t reason, void *object, int result);
+
+bool scheduler_unblock_one(task_tcb_t **wait_head, int result);
 
 /*
- * scheduler_unblock_all - Wake all tasks blocked on object/reason
+ * scheduler_unblock_all - Wake every waiter of a wait list
  *
  * Returns: Number of tasks unblocked
  */
- 
-uint32_t scheduler_unblock_all(block_reason_t reason, void *object, int result);
+
+uint32_t scheduler_unblock_all(task_tcb_t **wait_head, int result);
+
+/*
+ * scheduler_set_deadline - Give a task periodic job timing
+ *
+ * Starts the first job now. With CONFIG_EDF the task also joins the
+ * EDF class at CONFIG_EDF_PRIORITY and is ordered by absolute deadline.
+ *
+ * @tcb:          Task to update
+ * @period:       Job period in ticks (0 = one-shot deadline)
+ * @rel_deadline: Deadline relative to each release, in ticks
+ */
+
+void scheduler_set_deadline(task_tcb_t *tcb, uint32_t period, uint32_t rel_deadline);
+
+/*
+ * scheduler_wait_next_period - End the current job of a periodic task
+ *
+ * Blocks until the next release on the period grid, then re-arms the
+ * absolute deadline. A job that overran its period is released at once.
+ *
+ * Returns: KERNEL_OK, or KERNEL_ERR_TIMEOUT if the finished job
+ *          missed its deadline
+ */
+
+int scheduler_wait_next_period(void);
+
+#if CONFIG_PARTITIONS
+/*
+ * scheduler_set_partition_table - Install a validated major frame
+ */
+
+void scheduler_set_partition_table(const partition_window_t *windows, uint32_t count);
+
+/*
+ * scheduler_set_task_partition - Move a task to another ready queue
+ */
+
+void scheduler_set_task_partition(task_tcb_t *tcb, uint8_t partition);
+
+/*
+ * scheduler_get_partition - Partition owning the current window
+ */
+
+uint8_t scheduler_get_partition(void);
+#endif
+
+#if CONFIG_CPU_BUDGET
+/*
+ * scheduler_set_budget - Install or clear a task's CPU budget
+ *
+ * Starts a fresh replenish period now. See task_set_budget().
+ */
+
+void scheduler_set_budget(task_tcb_t *tcb, uint32_t cycles, uint32_t period, uint8_t policy);
+#endif
 
 /*
  * scheduler_get_current - Get currently running task
@@ -172,10 +382,13 @@ task_tcb_t *scheduler_get_next(void);
 /*
  * scheduler_select_next_task - Called by PendSV/context code
  *
+ * @cycles: DWT cycle count sampled at switch entry; the outgoing
+ *          task is charged for the cycles since the last sample
+ *
  * Returns the task that should run after the switch point.
  */
  
-task_tcb_t *scheduler_select_next_task(void);
+task_tcb_t *scheduler_select_next_task(uint32_t cycles);
 
 /*
  * scheduler_get_tick_count - Global scheduler tick
@@ -195,40 +408,59 @@ bool scheduler_is_locked(void);
 
 /*
  * Find highest priority (lowest bit set) in bitmap
- * Uses CLZ (Count Leading Zeros) instruction for O(1) lookup
+ * Uses CTZ (RBIT + CLZ on Cortex-M7) on each level for O(1) lookup
+ *
+ * Returns CONFIG_MAX_PRIORITY if no bit is set.
  */
  
-static inline uint8_t bitmap_find_highest(uint32_t bitmap)
+static inline uint32_t bitmap_find_highest(const prio_bitmap_t *bitmap)
+{
+    uint32_t group;
+
+    if (bitmap->group == 0U) return CONFIG_MAX_PRIORITY;
+    group = (uint32_t)__builtin_ctz(bitmap->group);
+    return (group << 5) | (uint32_t)__builtin_ctz(bitmap->words[group]);    // Lowest set bit is highest priority 
+}
+
+/*
+ * Check a priority against CONFIG_MAX_PRIORITY
+ * (takes uint32_t so the test stays meaningful at 256 levels)
+ */
+
+static inline bool priority_valid(uint32_t priority)
 {
-    if (bitmap == 0) return CONFIG_MAX_PRIORITY;
-    return (uint8_t)__builtin_ctz(bitmap);  // Lowest set bit is highest priority 
+    return priority < CONFIG_MAX_PRIORITY;
 }
 
 /*
  * Set bit in bitmap
  */
  
-static inline void bitmap_set(uint32_t *bitmap, uint8_t bit)
+static inline void bitmap_set(prio_bitmap_t *bitmap, uint8_t bit)
 {
-    *bitmap |= (1UL << bit);
+    bitmap->words[bit >> 5] |= (1UL << (bit & 31U));
+    bitmap->group |= (1UL << (bit >> 5));
 }
 
 /*
  * Clear bit in bitmap
  */
  
-static inline void bitmap_clear(uint32_t *bitmap, uint8_t bit)
+static inline void bitmap_clear(prio_bitmap_t *bitmap, uint8_t bit)
 {
-    *bitmap &= ~(1UL << bit);
+    bitmap->words[bit >> 5] &= ~(1UL << (bit & 31U));
+    if (bitmap->words[bit >> 5] == 0U) {
+        bitmap->group &= ~(1UL << (bit >> 5));
+    }
 }
 
 /*
  * Test bit in bitmap
  */
  
-static inline bool bitmap_test(uint32_t bitmap, uint8_t bit)
+static inline bool bitmap_test(const prio_bitmap_t *bitmap, uint8_t bit)
 {
-    return (bitmap & (1UL << bit)) != 0;
+    return (bitmap->words[bit >> 5] & (1UL << (bit & 31U))) != 0;
 }
 
 
@@ -241,8 +473,8 @@ static inline bool bitmap_test(uint32_t bitmap, uint8_t bit)
  
 static inline void scheduler_trigger_switch(void)
 {
-    // Set PENDSVSET bit in ICSR 
-    *((volatile uint32_t *)0xE000ED04) |= (1UL << 28);
+    // Set PENDSVSET bit in ICSR (write-1-to-set, no read needed)
+    *((volatile uint32_t *)0xE000ED04) = (1UL << 28);
 }
 
 /*
@@ -1,12 +1,68 @@
 // HelixRT - Critical Section API
  
-// Interrupt-safe critical sections using PRIMASK
+// Interrupt-safe critical sections using PRIMASK (or BASEPRI, see config.h)
  
 
 #ifndef CRITICAL_H
 #define CRITICAL_H
 
 #include <stdint.h>
+#include "../../include/config.h"
+
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY > 15
+#error "CONFIG_KERNEL_MAX_SYSCALL_PRIORITY must be 0-15 (4 priority bits)"
+#endif
+
+/* 
+ * BASEPRI-Based Critical Sections
+ * 
+ * These allow high-priority interrupts to still run while blocking
+ * lower-priority interrupts. Useful for real-time requirements
+ * 
+ * BASEPRI of 0 = all interrupts enabled
+ * BASEPRI of N = interrupts with priority >= N are disabled
+ */
+
+
+/*
+ * critical_enter_basepri - Enter critical section using BASEPRI
+ * 
+ * @max_priority: Maximum priority to disable (lower number = higher priority)
+ * 
+ * Returns: Previous BASEPRI value
+ */
+ 
+ 
+static inline uint32_t critical_enter_basepri(uint32_t max_priority)
+{
+    uint32_t basepri;
+    __asm volatile (
+        "mrs %0, basepri    \n"
+        "msr basepri_max, %1\n"    // Only ever raises the mask (nestable)
+        "isb                \n"
+        : "=r" (basepri)
+        : "r" (max_priority << 4)   // Priority is in upper 4 bits 
+        : "memory"
+    );
+    return basepri;
+}
+
+
+/*
+ * critical_exit_basepri - Exit BASEPRI-based critical section
+ * 
+ * @state: Value returned by critical_enter_basepri()
+ */
+ 
+static inline void critical_exit_basepri(uint32_t state)
+{
+    __asm volatile (
+        "msr basepri, %0    \n"
+        :
+        : "r" (state)
+        : "memory"
+    );
+}
 
 /*
  * Critical Section API
@@ -27,7 +83,9 @@
 /*
  * critical_enter - Enter critical section (disable interrupts)
  * 
- * Saves the current PRIMASK value and disables interrupts.
+ * Saves the current PRIMASK value and disables interrupts. With
+ * CONFIG_KERNEL_MAX_SYSCALL_PRIORITY set, raises BASEPRI to that level
+ * instead, leaving higher-priority ISRs running.
  * Can be nested - each enter must have a matching exit.
  * 
  * Returns: Previous interrupt state (for critical_exit)
@@ -36,6 +94,9 @@
  
 static inline uint32_t critical_enter(void)
 {
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    return critical_enter_basepri(CONFIG_KERNEL_MAX_SYSCALL_PRIORITY);
+#else
     uint32_t primask;
     __asm volatile (
         "mrs %0, primask    \n"     // Save current PRIMASK 
@@ -45,12 +106,13 @@ static inline uint32_t critical_enter(void)
         : "memory"
     );
     return primask;
+#endif
 }
 
 /*
  * critical_exit - Exit critical section (restore interrupts)
  * 
- * Restores the PRIMASK value that was saved by critical_enter.
+ * Restores the PRIMASK (or BASEPRI) value saved by critical_enter.
  * Only re-enables interrupts if they were enabled before critical_enter.
  * 
  * @state: Value returned by critical_enter()
@@ -59,62 +121,16 @@ static inline uint32_t critical_enter(void)
  
 static inline void critical_exit(uint32_t state)
 {
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    critical_exit_basepri(state);
+#else
     __asm volatile (
         "msr primask, %0    \n"     //Restore PRIMASK 
         :
         : "r" (state)
         : "memory"
     );
-}
-
-/* 
- * BASEPRI-Based Critical Sections (Alternative)
- * 
- * These allow high-priority interrupts to still run while blocking
- * lower-priority interrupts. Useful for real-time requirements
- * 
- * BASEPRI of 0 = all interrupts enabled
- * BASEPRI of N = interrupts with priority >= N are disabled
- */
-
-
-/*
- * critical_enter_basepri - Enter critical section using BASEPRI
- * 
- * @max_priority: Maximum priority to disable (lower number = higher priority)
- * 
- * Returns: Previous BASEPRI value
- */
- 
- 
-static inline uint32_t critical_enter_basepri(uint32_t max_priority)
-{
-    uint32_t basepri;
-    __asm volatile (
-        "mrs %0, basepri    \n"
-        "msr basepri, %1    \n"
-        : "=r" (basepri)
-        : "r" (max_priority << 4)   // Priority is in upper 4 bits 
-        : "memory"
-    );
-    return basepri;
-}
-
-
-/*
- * critical_exit_basepri - Exit BASEPRI-based critical section
- * 
- * @state: Value returned by critical_enter_basepri()
- */
- 
-static inline void critical_exit_basepri(uint32_t state)
-{
-    __asm volatile (
-        "msr basepri, %0    \n"
-        :
-        : "r" (state)
-        : "memory"
-    );
+#endif
 }
 
 // Interrupt State Query
@@ -131,7 +147,13 @@ static inline int is_irq_disabled(void)
 {
     uint32_t primask;
     __asm volatile ("mrs %0, primask" : "=r" (primask));
+#if CONFIG_KERNEL_MAX_SYSCALL_PRIORITY
+    uint32_t basepri;
+    __asm volatile ("mrs %0, basepri" : "=r" (basepri));
+    return (primask & 1) || basepri != 0;
+#else
     return primask & 1;
+#endif
 }
 
 /*
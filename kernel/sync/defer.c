@@ -0,0 +1,109 @@
+// HelixRT - Deferred ISR Wakeup Implementation
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../include/config.h"
+#include "defer.h"
+#include "../kernel.h"
+#include "../scheduler.h"
+#include "critical.h"
+#include "../../hal/imxrt1062.h"
+
+#if CONFIG_DEFERRED_WAKE
+
+#if (CONFIG_DEFER_RING_DEPTH & (CONFIG_DEFER_RING_DEPTH - 1)) != 0
+#error "CONFIG_DEFER_RING_DEPTH must be a power of two"
+#endif
+
+#define DEFER_MASK  (CONFIG_DEFER_RING_DEPTH - 1U)
+
+typedef struct {
+    task_tcb_t **wait_head;
+    uint8_t all;
+} defer_post_t;
+
+/*
+ * Producers (ISRs, possibly nested) claim slots by advancing g_head
+ * with LDREX/STREX; PendSV is the only consumer. PendSV has the lowest
+ * priority, so every slot it sees claimed has been fully written.
+ */
+static volatile defer_post_t g_ring[CONFIG_DEFER_RING_DEPTH];
+static volatile uint32_t g_head = 0;
+static volatile uint32_t g_tail = 0;
+static volatile uint32_t g_overflows = 0;
+
+static inline uint32_t defer_ldrex(volatile uint32_t *addr)
+{
+    uint32_t value;
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (addr) : "memory");
+    return value;
+}
+
+static inline uint32_t defer_strex(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t failed;
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (failed) : "r" (addr), "r" (value) : "memory");
+    return failed;
+}
+
+static inline void defer_clrex(void)
+{
+    __asm volatile ("clrex" ::: "memory");
+}
+
+bool defer_wake(task_tcb_t **wait_head, bool all)
+{
+    uint32_t head;
+
+    if (!is_isr_context() || *wait_head == NULL) {
+        return false;
+    }
+
+    do {
+        head = defer_ldrex(&g_head);
+        if (head - g_tail >= CONFIG_DEFER_RING_DEPTH) {
+            defer_clrex();
+            g_overflows++;
+            return false;
+        }
+    } while (defer_strex(head + 1U, &g_head) != 0U);
+
+    g_ring[head & DEFER_MASK].wait_head = wait_head;
+    g_ring[head & DEFER_MASK].all = all ? 1U : 0U;
+
+    scheduler_trigger_switch();
+    return true;
+}
+
+void defer_drain(void)
+{
+    task_tcb_t **wait_head;
+    uint8_t all;
+
+    for (;;) {
+        while (g_tail != g_head) {
+            wait_head = g_ring[g_tail & DEFER_MASK].wait_head;
+            all = g_ring[g_tail & DEFER_MASK].all;
+            g_tail++;
+
+            // One waiter per critical section keeps IRQ masking constant
+            while (scheduler_unblock_one(wait_head, KERNEL_OK) && all) {
+            }
+        }
+
+        // The wakeups above re-pended PendSV, and it is running now.
+        // A post after the emptiness check pends it again by itself.
+        SCB_ICSR = SCB_ICSR_PENDSVCLR;
+        if (g_tail == g_head) {
+            break;
+        }
+    }
+}
+
+uint32_t defer_get_overflows(void)
+{
+    return g_overflows;
+}
+
+#endif
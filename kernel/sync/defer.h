@@ -0,0 +1,68 @@
+// HelixRT - Deferred ISR Wakeup API
+
+// Interrupt handlers do not walk wait lists. They post a small record
+// into a lock-free ring and PendSV makes the waiters ready before it
+// picks the next task, so ISR time does not grow with the number of
+// waiters.
+
+
+#ifndef DEFER_H
+#define DEFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../include/config.h"
+#include "../task.h"
+
+#ifndef CONFIG_DEFERRED_WAKE
+#define CONFIG_DEFERRED_WAKE    0
+#endif
+
+#ifndef CONFIG_DEFER_RING_DEPTH
+#define CONFIG_DEFER_RING_DEPTH 16
+#endif
+
+#if CONFIG_DEFERRED_WAKE
+
+/*
+ * defer_wake - Post a wakeup of a wait list from ISR context
+ *
+ * Constant time. Woken tasks re-check their condition, so the caller
+ * updates the object state first, as for a direct wakeup.
+ *
+ * @wait_head: Wait list of the object
+ * @all:       Wake every waiter instead of the best one
+ *
+ * Returns: true if posted; false in thread mode, with no waiters or
+ *          with the ring full, and the caller wakes directly
+ */
+
+bool defer_wake(task_tcb_t **wait_head, bool all);
+
+/*
+ * defer_drain - Perform posted wakeups (called by PendSV)
+ *
+ * Runs with interrupts enabled; each waiter is woken in its own short
+ * critical section.
+ */
+
+void defer_drain(void);
+
+/*
+ * defer_get_overflows - Posts that found the ring full
+ */
+
+uint32_t defer_get_overflows(void);
+
+#else
+
+static inline bool defer_wake(task_tcb_t **wait_head, bool all)
+{
+    (void)wait_head;
+    (void)all;
+    return false;
+}
+
+#endif
+
+#endif // DEFER_H
@@ -9,6 +9,7 @@
 #include "../scheduler.h"
 #include "../task.h"
 #include "critical.h"
+#include "defer.h"
 
 static int event_match(uint32_t current, uint32_t bits, uint8_t wait_all)
 {
@@ -24,6 +25,8 @@ int event_init(event_group_t *eg)
         return KERNEL_ERR_PARAM;
     }
     eg->flags = 0;
+    eg->wait_list_head = NULL;
+    eg->wait_list_tail = NULL;
     return KERNEL_OK;
 }
 
@@ -40,10 +43,13 @@ int event_set(event_group_t *eg, uint32_t bits)
     
     /*
      * Wake all waiters; each task re-checks its own condition and either
-     * consumes bits or blocks again.
+     * consumes bits or blocks again. From an ISR the walk is left to
+     * PendSV.
      */
      
-    (void)scheduler_unblock_all(BLOCK_EVENT, eg, KERNEL_OK);
+    if (!defer_wake(&eg->wait_list_head, true)) {
+        (void)scheduler_unblock_all(&eg->wait_list_head, KERNEL_OK);
+    }
     critical_exit(irq_state);
     return KERNEL_OK;
 }
@@ -106,7 +112,8 @@ uint32_t event_wait(event_group_t *eg, uint32_t bits, uint8_t wait_all, uint32_t
             return 0;
         }
 
-        res = scheduler_block_task(BLOCK_EVENT, eg, timeout);
+        res = scheduler_block_on(BLOCK_EVENT, eg,
+                                 &eg->wait_list_head, &eg->wait_list_tail, timeout);
         if (res != KERNEL_OK) {
             return 0;
         }
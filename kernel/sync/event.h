@@ -5,9 +5,12 @@
 #define EVENT_H
 
 #include <stdint.h>
+#include "../task.h"
 
 typedef struct event_group {
     volatile uint32_t flags;
+    task_tcb_t *wait_list_head;
+    task_tcb_t *wait_list_tail;
 } event_group_t;
 
 #define EVENT_WAIT_ANY          0U
@@ -9,6 +9,77 @@
 #include "../scheduler.h"
 #include "critical.h"
 
+uint8_t mutex_effective_priority(const task_tcb_t *tcb)
+{
+    uint8_t prio = tcb->base_priority;
+    const mutex_t *held;
+
+    for (held = tcb->mutex_held; held != NULL; held = held->held_next) {
+        if (held->flags & MUTEX_FLAG_CEILING) {
+            if (held->ceiling < prio) {
+                prio = held->ceiling;
+            }
+        }
+#if CONFIG_PRIORITY_INHERITANCE
+        // Wait lists are priority sorted: the head is the top waiter
+        else if (held->wait_list_head != NULL && held->wait_list_head->priority < prio) {
+            prio = held->wait_list_head->priority;
+        }
+#endif
+    }
+#if CONFIG_PREEMPT_THRESHOLD
+    if ((tcb->flags & TASK_FLAG_THRESHOLD) && tcb->threshold < prio) {
+        prio = tcb->threshold;
+    }
+#endif
+#if CONFIG_CPU_BUDGET
+    // An overrun demotion outranks every boost until the budget refills
+    if (tcb->budget_depleted && tcb->budget_policy == BUDGET_POLICY_DEMOTE &&
+        prio < CONFIG_BUDGET_DEMOTE_PRIORITY) {
+        prio = (uint8_t)CONFIG_BUDGET_DEMOTE_PRIORITY;
+    }
+#endif
+    return prio;
+}
+
+static void mutex_held_remove(task_tcb_t *tcb, mutex_t *mtx)
+{
+    mutex_t **link = &tcb->mutex_held;
+
+    while (*link != NULL) {
+        if (*link == mtx) {
+            *link = mtx->held_next;
+            break;
+        }
+        link = &(*link)->held_next;
+    }
+    mtx->held_next = NULL;
+}
+
+void mutex_priority_update(task_tcb_t *tcb)
+{
+    uint32_t depth;
+    uint8_t prio;
+    uint32_t irq_state = critical_enter();
+
+    // Bounded so a deadlock cycle cannot spin here forever
+    for (depth = 0; tcb != NULL && depth < CONFIG_MAX_TASKS; depth++) {
+        prio = mutex_effective_priority(tcb);
+        if (prio == tcb->priority) {
+            break;
+        }
+        // Also re-sorts tcb in the wait list it may be queued on
+        scheduler_set_priority(tcb, prio);
+
+        if (tcb->state != TASK_STATE_BLOCKED || tcb->block_reason != BLOCK_MUTEX) {
+            break;
+        }
+        tcb = ((mutex_t *)tcb->block_object)->owner;
+    }
+
+    critical_exit(irq_state);
+}
+
 int mutex_init(mutex_t *mtx, uint8_t flags)
 {
     if (mtx == NULL) {
@@ -17,11 +88,23 @@ int mutex_init(mutex_t *mtx, uint8_t flags)
 
     mtx->locked = 0;
     mtx->owner = NULL;
-    mtx->owner_base_priority = 0;
     mtx->recursive_count = 0;
     mtx->flags = flags;
+    mtx->ceiling = 0;
     mtx->wait_list_head = NULL;
     mtx->wait_list_tail = NULL;
+    mtx->held_next = NULL;
+    return KERNEL_OK;
+}
+
+int mutex_init_ceiling(mutex_t *mtx, uint8_t flags, uint8_t ceiling)
+{
+    if (mtx == NULL || !priority_valid(ceiling)) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    (void)mutex_init(mtx, (uint8_t)(flags | MUTEX_FLAG_CEILING));
+    mtx->ceiling = ceiling;
     return KERNEL_OK;
 }
 
@@ -45,10 +128,17 @@ int mutex_trylock(mutex_t *mtx)
     irq_state = critical_enter();
 
     if (!mtx->locked) {
+        if ((mtx->flags & MUTEX_FLAG_CEILING) && self->base_priority < mtx->ceiling) {
+            critical_exit(irq_state);
+            return KERNEL_ERR_PARAM;
+        }
         mtx->locked = 1;
         mtx->owner = self;
-        mtx->owner_base_priority = self->priority;
         mtx->recursive_count = 1;
+        mtx->held_next = self->mutex_held;
+        self->mutex_held = mtx;
+        // Immediate ceiling, or waiters left behind by the last owner
+        mutex_priority_update(self);
         critical_exit(irq_state);
         return KERNEL_OK;
     }
@@ -84,21 +174,18 @@ int mutex_lock(mutex_t *mtx, uint32_t timeout)
 
     while (1) {
         res = mutex_trylock(mtx);
-        if (res == KERNEL_OK) {
-            return KERNEL_OK;
+        if (res != KERNEL_ERR_TIMEOUT) {
+            return res;
         }
 
         if (timeout == TIMEOUT_NONE) {
             return KERNEL_ERR_TIMEOUT;
         }
 
-#if CONFIG_PRIORITY_INHERITANCE
-        if (mtx->owner != NULL && mtx->owner->priority > self->priority) {
-            scheduler_set_priority(mtx->owner, self->priority);
-        }
-#endif
-
-        res = scheduler_block_task(BLOCK_MUTEX, mtx, timeout);
+        // Queues the caller, then boosts the owner chain in the same
+        // critical section
+        res = scheduler_block_on(BLOCK_MUTEX, mtx,
+                                 &mtx->wait_list_head, &mtx->wait_list_tail, timeout);
         if (res != KERNEL_OK) {
             return res;
         }
@@ -130,17 +217,15 @@ int mutex_unlock(mutex_t *mtx)
         return KERNEL_OK;
     }
 
-#if CONFIG_PRIORITY_INHERITANCE
-    if (self->priority != self->base_priority) {
-        scheduler_set_priority(self, self->base_priority);
-    }
-#endif
-
+    mutex_held_remove(self, mtx);
     mtx->locked = 0;
     mtx->owner = NULL;
     mtx->recursive_count = 0;
 
-    (void)scheduler_unblock_one(BLOCK_MUTEX, mtx, KERNEL_OK);
+    (void)scheduler_unblock_one(&mtx->wait_list_head, KERNEL_OK);
+
+    // Drop only as far as the mutexes still held allow
+    mutex_priority_update(self);
 
     critical_exit(irq_state);
     return KERNEL_OK;
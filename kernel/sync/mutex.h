@@ -14,15 +14,17 @@
 typedef struct mutex {
     volatile uint8_t locked;          
     task_tcb_t *owner;                
-    uint8_t owner_base_priority;      
     uint8_t recursive_count;           
     uint8_t flags;                    
+    uint8_t ceiling;                  // Ceiling priority (MUTEX_FLAG_CEILING)
     task_tcb_t *wait_list_head;        
     task_tcb_t *wait_list_tail;        
+    struct mutex *held_next;          // Owner's held-mutex list link
 } mutex_t;
 
 // Mutex flags 
 #define MUTEX_FLAG_RECURSIVE    (1 << 0)    //Allow recursive locking 
+#define MUTEX_FLAG_CEILING      (1 << 1)    // Immediate priority ceiling 
 
 // Mutex API
 
@@ -38,12 +40,31 @@ typedef struct mutex {
  
 int mutex_init(mutex_t *mtx, uint8_t flags);
 
+/*
+ * mutex_init_ceiling - Initialize an immediate priority-ceiling mutex
+ *
+ * The locker runs at @ceiling for as long as it holds the mutex, so no
+ * task that uses the mutex can preempt the holder and then contend for
+ * it. The ceiling must be at least as high (numerically <=) as the
+ * priority of every task that locks the mutex.
+ *
+ * @mtx:     Pointer to mutex structure
+ * @flags:   Mutex flags (MUTEX_FLAG_CEILING is implied)
+ * @ceiling: Ceiling priority
+ *
+ * Returns: KERNEL_OK or error code
+ */
+
+int mutex_init_ceiling(mutex_t *mtx, uint8_t flags, uint8_t ceiling);
+
 /*
  * mutex_lock - Lock the mutex
  * 
  * If unlocked, locks and returns immediately.
  * If locked by another task, blocks and may raise owner's priority.
  * If locked by same task and recursive, increments count.
+ * Ceiling mutexes raise the caller to the ceiling on acquire and return
+ * KERNEL_ERR_PARAM if the caller's priority is above the ceiling.
  * 
  * @mtx:     Mutex to lock
  * @timeout: Timeout in ticks (0 = no wait, UINT32_MAX = infinite)
@@ -69,7 +90,7 @@ int mutex_trylock(mutex_t *mtx);
  * mutex_unlock - Unlock the mutex
  * 
  * Must be called by the owner. Restores owner's priority if it was
- * raised due to priority inheritance.
+ * raised due to priority inheritance or a priority ceiling.
  * 
  * @mtx: Mutex to unlock
  * 
@@ -88,6 +109,27 @@ int mutex_unlock(mutex_t *mtx);
  
 task_tcb_t *mutex_get_owner(mutex_t *mtx);
 
+/*
+ * mutex_priority_update - Recompute a task's effective priority
+ *
+ * Effective priority is the highest of the task's base priority, the
+ * ceiling of every ceiling mutex it holds and (with priority
+ * inheritance) the top waiter of every other mutex it holds. If the
+ * task is itself waiting on a mutex, the change is carried on to that
+ * mutex's owner, and so on down the chain. A task demoted for a budget
+ * overrun stays at CONFIG_BUDGET_DEMOTE_PRIORITY until it is refilled.
+ *
+ * Used by the kernel when a waiter queues, times out or is removed,
+ * when a base priority changes and when a budget overruns or refills.
+ *
+ * @tcb: Task to update (NULL is ignored)
+ */
+
+void mutex_priority_update(task_tcb_t *tcb);
+
+// Priority mutex_priority_update() would give @tcb, without applying it
+uint8_t mutex_effective_priority(const task_tcb_t *tcb);
+
 /*
  * mutex_is_locked - Check if mutex is locked
  * 
@@ -108,37 +150,64 @@ static inline int mutex_is_locked(mutex_t *mtx)
  * 
  * 1. mutex_lock() detects the priority inversion
  * 2. Owner's priority is temporarily raised to blocker's priority
- * 3. Owner is moved to higher priority queue in scheduler
+ * 3. If that owner is itself blocked on a mutex, the boost is carried
+ *    on to the next owner (transitive, bounded by CONFIG_MAX_TASKS)
  * 4. When mutex_unlock() is called:
- *    a. Owner's priority is restored to base_priority
+ *    a. Mutex leaves the owner's held list
  *    b. Highest priority waiter is woken
- *    c. Scheduler is invoked if woken task has higher priority
+ *    c. Owner's priority is recomputed from base_priority and the
+ *       mutexes it still holds
+ * 5. A waiter that times out triggers the same recompute on the owner
  * 
  * This prevents unbounded priority inversion.
  */
 
+/*
+ * Priority Ceiling Notes
+ *
+ * With MUTEX_FLAG_CEILING the owner is raised on acquire rather than on
+ * contention, so on one core a contender of priority <= ceiling cannot
+ * run until the mutex is free. Locking takes no inheritance step, and
+ * unlocking recomputes the priority like any other mutex. Blocking on
+ * one is only possible for round-robin peers at the ceiling level.
+ */
+
 //Static Mutex Allocation
 
 #define MUTEX_STATIC_DEFINE(name)                       \
     static mutex_t name = {                             \
         .locked = 0,                                    \
         .owner = NULL,                                  \
-        .owner_base_priority = 0,                       \
         .recursive_count = 0,                           \
         .flags = 0,                                     \
+        .ceiling = 0,                                   \
         .wait_list_head = NULL,                         \
-        .wait_list_tail = NULL                          \
+        .wait_list_tail = NULL,                         \
+        .held_next = NULL                               \
     }
 
 #define MUTEX_RECURSIVE_DEFINE(name)                    \
     static mutex_t name = {                             \
         .locked = 0,                                    \
         .owner = NULL,                                  \
-        .owner_base_priority = 0,                       \
         .recursive_count = 0,                           \
         .flags = MUTEX_FLAG_RECURSIVE,                  \
+        .ceiling = 0,                                   \
+        .wait_list_head = NULL,                         \
+        .wait_list_tail = NULL,                         \
+        .held_next = NULL                               \
+    }
+
+#define MUTEX_CEILING_DEFINE(name, prio)                \
+    static mutex_t name = {                             \
+        .locked = 0,                                    \
+        .owner = NULL,                                  \
+        .recursive_count = 0,                           \
+        .flags = MUTEX_FLAG_CEILING,                    \
+        .ceiling = (prio),                              \
         .wait_list_head = NULL,                         \
-        .wait_list_tail = NULL                          \
+        .wait_list_tail = NULL,                         \
+        .held_next = NULL                               \
     }
 
 #endif //MUTEX_H
@@ -0,0 +1,117 @@
+// HelixRT - Task Notification Implementation
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../include/config.h"
+#include "notify.h"
+#include "../kernel.h"
+#include "../scheduler.h"
+#include "critical.h"
+
+#if CONFIG_TASK_NOTIFY
+
+static int notify_send(task_tcb_t *tcb, uint32_t value, notify_action_t action)
+{
+    uint32_t irq_state;
+
+    if (tcb == NULL) {
+        return KERNEL_ERR_PARAM;
+    }
+
+    irq_state = critical_enter();
+
+    switch (action) {
+    case NOTIFY_NONE:
+        break;
+    case NOTIFY_SET_BITS:
+        tcb->notify_value |= value;
+        break;
+    case NOTIFY_INCREMENT:
+        tcb->notify_value++;
+        break;
+    case NOTIFY_OVERWRITE:
+        tcb->notify_value = value;
+        break;
+    case NOTIFY_NO_OVERWRITE:
+        if (tcb->notify_pending) {
+            critical_exit(irq_state);
+            return KERNEL_ERR_OVERFLOW;
+        }
+        tcb->notify_value = value;
+        break;
+    default:
+        critical_exit(irq_state);
+        return KERNEL_ERR_PARAM;
+    }
+
+    tcb->notify_pending = 1U;
+
+    // The waiter is known: no wait list to search
+    if (tcb->state == TASK_STATE_BLOCKED &&
+        (tcb->block_reason == BLOCK_NOTIFY || tcb->block_reason == BLOCK_JOB)) {
+        scheduler_unblock_task(tcb, KERNEL_OK);
+    }
+
+    critical_exit(irq_state);
+    return KERNEL_OK;
+}
+
+int task_notify(task_tcb_t *tcb, uint32_t value, notify_action_t action)
+{
+    return notify_send(tcb, value, action);
+}
+
+int task_notify_isr(task_tcb_t *tcb, uint32_t value, notify_action_t action)
+{
+    return notify_send(tcb, value, action);
+}
+
+int task_notify_wait(uint32_t clear_on_entry, uint32_t clear_on_exit,
+                     uint32_t *value, uint32_t timeout)
+{
+    task_tcb_t *self;
+    uint32_t irq_state;
+    uint8_t pending;
+    int res = KERNEL_OK;
+
+    if (is_isr_context()) {
+        return KERNEL_ERR_ISR;
+    }
+    self = task_get_current();
+    if (self == NULL) {
+        return KERNEL_ERR_STATE;
+    }
+
+    irq_state = critical_enter();
+    pending = self->notify_pending;
+    if (!pending) {
+        self->notify_value &= ~clear_on_entry;
+    }
+    critical_exit(irq_state);
+
+    if (!pending) {
+        if (timeout == TIMEOUT_NONE) {
+            return KERNEL_ERR_TIMEOUT;
+        }
+        // Re-checks notify_pending atomically before actually blocking
+        res = scheduler_block_task(BLOCK_NOTIFY, NULL, timeout);
+    }
+
+    irq_state = critical_enter();
+    if (self->notify_pending) {
+        if (value != NULL) {
+            *value = self->notify_value;
+        }
+        self->notify_value &= ~clear_on_exit;
+        self->notify_pending = 0U;
+        res = KERNEL_OK;
+    } else if (res == KERNEL_OK) {
+        res = KERNEL_ERR_TIMEOUT;
+    }
+    critical_exit(irq_state);
+
+    return res;
+}
+
+#endif
@@ -0,0 +1,66 @@
+// HelixRT - Task Notification API
+
+// Direct-to-task signalling: the notifier writes the target TCB, so one
+// producer waking one known consumer needs no semaphore or wait list.
+
+
+#ifndef NOTIFY_H
+#define NOTIFY_H
+
+#include <stdint.h>
+#include "../task.h"
+
+// Notification Actions
+
+typedef enum {
+    NOTIFY_NONE         = 0,    // Only mark pending, value unchanged
+    NOTIFY_SET_BITS     = 1,    // value |= arg (event-flag style)
+    NOTIFY_INCREMENT    = 2,    // value++ (counting-semaphore style)
+    NOTIFY_OVERWRITE    = 3,    // value = arg (mailbox style)
+    NOTIFY_NO_OVERWRITE = 4,    // value = arg unless one is still pending
+} notify_action_t;
+
+// Clear every bit (for task_notify_wait clear masks)
+#define NOTIFY_CLEAR_ALL        UINT32_MAX
+
+// Task Notification API
+
+/*
+ * task_notify - Send a notification to a task
+ *
+ * Updates the target's notification value and marks it pending. If the
+ * target is blocked in task_notify_wait() it is made ready directly.
+ *
+ * @tcb:    Task to notify
+ * @value:  Argument for @action
+ * @action: How to update the notification value
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_PARAM, or KERNEL_ERR_OVERFLOW if
+ *          NOTIFY_NO_OVERWRITE found a value still pending
+ */
+
+int task_notify(task_tcb_t *tcb, uint32_t value, notify_action_t action);
+
+/*
+ * task_notify_isr - Send a notification from ISR context
+ *
+ * Same as task_notify but safe to call from interrupt handlers.
+ */
+
+int task_notify_isr(task_tcb_t *tcb, uint32_t value, notify_action_t action);
+
+/*
+ * task_notify_wait - Wait for a notification to the calling task
+ *
+ * @clear_on_entry: Bits cleared in the value if nothing is pending yet
+ * @clear_on_exit:  Bits cleared in the value after it has been read
+ * @value:          Receives the value before clear_on_exit (can be NULL)
+ * @timeout:        Timeout in ticks (0 = no wait, UINT32_MAX = infinite)
+ *
+ * Returns: KERNEL_OK, KERNEL_ERR_TIMEOUT, or error code
+ */
+
+int task_notify_wait(uint32_t clear_on_entry, uint32_t clear_on_exit,
+                     uint32_t *value, uint32_t timeout);
+
+#endif // NOTIFY_H
@@ -8,6 +8,7 @@
 #include "../kernel.h"
 #include "../scheduler.h"
 #include "critical.h"
+#include "defer.h"
 
 static void mem_copy(uint8_t *dst, const uint8_t *src, uint32_t len)
 {
@@ -78,7 +79,7 @@ int queue_send(msg_queue_t *queue, const void *msg, uint32_t timeout)
         irq_state = critical_enter();
         if (queue->count < queue->capacity) {
             queue_push_back(queue, msg);
-            (void)scheduler_unblock_one(BLOCK_QUEUE_RECV, queue, KERNEL_OK);
+            (void)scheduler_unblock_one(&queue->recv_wait_head, KERNEL_OK);
             critical_exit(irq_state);
             return KERNEL_OK;
         }
@@ -91,7 +92,8 @@ int queue_send(msg_queue_t *queue, const void *msg, uint32_t timeout)
             return KERNEL_ERR_ISR;
         }
 
-        res = scheduler_block_task(BLOCK_QUEUE_SEND, queue, timeout);
+        res = scheduler_block_on(BLOCK_QUEUE_SEND, queue,
+                                 &queue->send_wait_head, &queue->send_wait_tail, timeout);
         if (res != KERNEL_OK) {
             return res;
         }
@@ -111,7 +113,7 @@ int queue_send_front(msg_queue_t *queue, const void *msg, uint32_t timeout)
         irq_state = critical_enter();
         if (queue->count < queue->capacity) {
             queue_push_front(queue, msg);
-            (void)scheduler_unblock_one(BLOCK_QUEUE_RECV, queue, KERNEL_OK);
+            (void)scheduler_unblock_one(&queue->recv_wait_head, KERNEL_OK);
             critical_exit(irq_state);
             return KERNEL_OK;
         }
@@ -124,7 +126,8 @@ int queue_send_front(msg_queue_t *queue, const void *msg, uint32_t timeout)
             return KERNEL_ERR_ISR;
         }
 
-        res = scheduler_block_task(BLOCK_QUEUE_SEND, queue, timeout);
+        res = scheduler_block_on(BLOCK_QUEUE_SEND, queue,
+                                 &queue->send_wait_head, &queue->send_wait_tail, timeout);
         if (res != KERNEL_OK) {
             return res;
         }
@@ -146,7 +149,9 @@ int queue_send_isr(msg_queue_t *queue, const void *msg)
     }
 
     queue_push_back(queue, msg);
-    (void)scheduler_unblock_one(BLOCK_QUEUE_RECV, queue, KERNEL_OK);
+    if (!defer_wake(&queue->recv_wait_head, false)) {
+        (void)scheduler_unblock_one(&queue->recv_wait_head, KERNEL_OK);
+    }
     critical_exit(irq_state);
     return KERNEL_OK;
 }
@@ -164,7 +169,7 @@ int queue_receive(msg_queue_t *queue, void *msg, uint32_t timeout)
         irq_state = critical_enter();
         if (queue->count > 0U) {
             queue_pop(queue, msg);
-            (void)scheduler_unblock_one(BLOCK_QUEUE_SEND, queue, KERNEL_OK);
+            (void)scheduler_unblock_one(&queue->send_wait_head, KERNEL_OK);
             critical_exit(irq_state);
             return KERNEL_OK;
         }
@@ -177,7 +182,8 @@ int queue_receive(msg_queue_t *queue, void *msg, uint32_t timeout)
             return KERNEL_ERR_ISR;
         }
 
-        res = scheduler_block_task(BLOCK_QUEUE_RECV, queue, timeout);
+        res = scheduler_block_on(BLOCK_QUEUE_RECV, queue,
+                                 &queue->recv_wait_head, &queue->recv_wait_tail, timeout);
         if (res != KERNEL_OK) {
             return res;
         }
@@ -209,7 +215,8 @@ int queue_peek(msg_queue_t *queue, void *msg, uint32_t timeout)
             return KERNEL_ERR_ISR;
         }
 
-        res = scheduler_block_task(BLOCK_QUEUE_RECV, queue, timeout);
+        res = scheduler_block_on(BLOCK_QUEUE_RECV, queue,
+                                 &queue->recv_wait_head, &queue->recv_wait_tail, timeout);
         if (res != KERNEL_OK) {
             return res;
         }
@@ -241,7 +248,7 @@ int queue_reset(msg_queue_t *queue)
     queue->head = 0;
     queue->tail = 0;
     queue->count = 0;
-    (void)scheduler_unblock_all(BLOCK_QUEUE_SEND, queue, KERNEL_ERR_STATE);
-    (void)scheduler_unblock_all(BLOCK_QUEUE_RECV, queue, KERNEL_ERR_STATE);
+    (void)scheduler_unblock_all(&queue->send_wait_head, KERNEL_ERR_STATE);
+    (void)scheduler_unblock_all(&queue->recv_wait_head, KERNEL_ERR_STATE);
     return KERNEL_OK;
 }
@@ -8,6 +8,7 @@
 #include "../kernel.h"
 #include "../scheduler.h"
 #include "critical.h"
+#include "defer.h"
 
 int sem_init(semaphore_t *sem, int32_t initial, int32_t max_count)
 {
@@ -47,7 +48,8 @@ int sem_take(semaphore_t *sem, uint32_t timeout)
             return KERNEL_ERR_ISR;
         }
 
-        res = scheduler_block_task(BLOCK_SEMAPHORE, sem, timeout);
+        res = scheduler_block_on(BLOCK_SEMAPHORE, sem,
+                                 &sem->wait_list_head, &sem->wait_list_tail, timeout);
         if (res != KERNEL_OK) {
             return res;
         }
@@ -64,30 +66,40 @@ int sem_give(semaphore_t *sem)
 
     irq_state = critical_enter();
 
-    if (!scheduler_unblock_one(BLOCK_SEMAPHORE, sem, KERNEL_OK)) {
-        if (sem->max_count > 0 && sem->count >= sem->max_count) {
-            critical_exit(irq_state);
-            return KERNEL_ERR_OVERFLOW;
-        }
-        sem->count++;
+    if (sem->max_count > 0 && sem->count >= sem->max_count) {
+        critical_exit(irq_state);
+        return KERNEL_ERR_OVERFLOW;
     }
 
+    // The count carries the unit: a woken taker re-checks it and takes it
+    sem->count++;
+    (void)scheduler_unblock_one(&sem->wait_list_head, KERNEL_OK);
+
     critical_exit(irq_state);
     return KERNEL_OK;
 }
 
 int sem_give_isr(semaphore_t *sem)
 {
+    uint32_t irq_state;
+
     if (sem == NULL) {
         return KERNEL_ERR_PARAM;
     }
 
-    if (!scheduler_unblock_one(BLOCK_SEMAPHORE, sem, KERNEL_OK)) {
-        if (sem->max_count > 0 && sem->count >= sem->max_count) {
-            return KERNEL_ERR_OVERFLOW;
-        }
-        sem->count++;
+    irq_state = critical_enter();
+
+    if (sem->max_count > 0 && sem->count >= sem->max_count) {
+        critical_exit(irq_state);
+        return KERNEL_ERR_OVERFLOW;
     }
+
+    sem->count++;
+    if (!defer_wake(&sem->wait_list_head, false)) {
+        (void)scheduler_unblock_one(&sem->wait_list_head, KERNEL_OK);
+    }
+
+    critical_exit(irq_state);
     return KERNEL_OK;
 }
 
@@ -106,6 +118,6 @@ int sem_reset(semaphore_t *sem, int32_t new_count)
     }
 
     sem->count = new_count;
-    (void)scheduler_unblock_all(BLOCK_SEMAPHORE, sem, KERNEL_ERR_STATE);
+    (void)scheduler_unblock_all(&sem->wait_list_head, KERNEL_ERR_STATE);
     return KERNEL_OK;
 }
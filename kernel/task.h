@@ -10,6 +10,7 @@
 #define TASK_H
 
 #include <stdint.h>
+#include "../include/config.h"
 
 // Task Configuration
  
@@ -17,6 +18,24 @@
 #define TASK_STACK_MIN          256
 #define TASK_STACK_GUARD        0xDEADBEEF
 #define TASK_STACK_FILL         0xCDCDCDCD
+#define TASK_EDF_INDEX_NONE     0xFFFF
+
+#ifndef CONFIG_STACK_SCAN_WORDS
+#define CONFIG_STACK_SCAN_WORDS 32
+#endif
+
+#ifndef CONFIG_JITTER_HIST
+#define CONFIG_JITTER_HIST      0
+#endif
+
+#ifndef CONFIG_JITTER_HIST_BUCKETS
+#define CONFIG_JITTER_HIST_BUCKETS 16
+#endif
+
+// Upper bound of jitter_hist[0] is 2^TASK_JITTER_SHIFT cycles
+#define TASK_JITTER_SHIFT       6
+
+struct mutex;
 
 // Task State
 
@@ -38,6 +57,11 @@ typedef enum {
     BLOCK_QUEUE_SEND    = 4,    // Queue full, waiting to send 
     BLOCK_QUEUE_RECV    = 5,    // Queue empty, waiting to receive 
     BLOCK_EVENT         = 6,    // Waiting for event flags 
+    BLOCK_PERIOD        = 7,    // Waiting for next job release
+    BLOCK_BUDGET        = 8,    // CPU budget exhausted, waiting for refill
+    BLOCK_NOTIFY        = 9,    // Waiting for a task notification
+    BLOCK_JOB           = 10,   // Shared-stack job idle, stack released
+    BLOCK_HRTIMER       = 11,   // hrtimer_sleep_us()
 } block_reason_t;
 
 /* 
@@ -52,6 +76,9 @@ typedef struct task_tcb {
     // Assembly context switch accesses this at offset 0 
     
     uint32_t *sp;
+
+    // PendSV overflow check reads this at offset 4
+    uint32_t *stack_base;
     
     // Scheduler Queue Links
     struct task_tcb *next;         
@@ -68,14 +95,17 @@ typedef struct task_tcb {
     uint8_t base_priority; 
     task_state_t state;       
     uint8_t flags;                 
+    uint8_t partition;              // Time partition (0 = system)
+#if CONFIG_PREEMPT_THRESHOLD
+    uint8_t threshold;              // Only tasks above this preempt it
+#endif
     
     // Stack Information 
-    uint32_t *stack_base;           
     uint32_t *stack_top;            
     uint32_t stack_size;          
     
     // Timing 
-    uint32_t delay_ticks;          
+    uint32_t delay_ticks;           // Timeout-list delta to previous entry
     uint32_t time_slice;            
     uint32_t wake_tick;             
     
@@ -84,17 +114,70 @@ typedef struct task_tcb {
     void *block_object;             
     uint32_t block_timeout;         
     int block_result;               
-    
+
+    // Mutexes currently owned (effective priority is derived from them)
+    struct mutex *mutex_held;
+
+    // Object Wait List (priority ordered, FIFO within a priority)
+    struct task_tcb **wait_head;    // Owning list head (NULL = not queued)
+    struct task_tcb **wait_tail;
+    struct task_tcb *wait_next;
+    struct task_tcb *wait_prev;
+
+    // Deadline Scheduling (periodic jobs / EDF class)
+    uint32_t period;                // Job period in ticks (0 = aperiodic)
+    uint32_t rel_deadline;          // Deadline relative to release
+    uint32_t release_tick;          // Release tick of current job
+    uint32_t deadline;              // Absolute deadline of current job
+    uint32_t deadline_misses;       // Jobs that completed past deadline
+    uint32_t release_misses;        // task_delay_until() releases already past
+    uint32_t wcet;                  // Admitted worst-case execution per job
+    uint16_t edf_index;             // Slot in EDF ready heap
+
     //Statistics (Optional) 
-#ifdef CONFIG_TASK_STATS
-    uint32_t run_count;             
-    uint32_t total_ticks;          
-    uint32_t max_stack_used;        
+#if CONFIG_TASK_STATS
+    uint32_t run_count;             // Times dispatched by PendSV
+    uint32_t total_ticks;           // Ticks that found this task running
+    uint32_t max_stack_used;        // Deepest use seen by the idle scan, bytes
+#if CONFIG_STACK_CHECK
+    struct task_tcb *list_next;     // Kernel task list (idle stack scan)
+#endif
+    uint64_t total_cycles;          // DWT cycles spent running
+#endif
+
+#if CONFIG_JITTER_HIST
+    /*
+     * task_delay_until() release lateness, cycles from the release
+     * tick's interrupt to the task running again. Bucket 0 counts
+     * lateness below 2^TASK_JITTER_SHIFT, bucket n the range
+     * [2^(TASK_JITTER_SHIFT+n-1), 2^(TASK_JITTER_SHIFT+n)), and the
+     * last bucket everything above.
+     */
+    uint32_t jitter_hist[CONFIG_JITTER_HIST_BUCKETS];
+    uint32_t jitter_max;            // Worst lateness seen, cycles
+#endif
+
+#if CONFIG_CPU_BUDGET
+    // CPU Budget (DWT cycles per replenish period)
+    uint32_t budget_cycles;         // Allowance per period (0 = unlimited)
+    uint32_t budget_used;           // Cycles consumed this period
+    uint32_t budget_period;         // Replenish period in ticks
+    uint32_t budget_replenish;      // Tick of next replenishment
+    uint32_t budget_overruns;       // Periods in which the budget ran out
+    struct task_tcb *budget_next;   // Depleted-list link
+    uint8_t budget_policy;
+    uint8_t budget_depleted;
 #endif
     
     //Event Waiting 
     uint32_t event_wait_bits;      
     uint8_t event_wait_all;        
+
+#if CONFIG_TASK_NOTIFY
+    // Direct-to-task Notification
+    uint32_t notify_value;
+    uint8_t notify_pending;         // Set by notifier, cleared by wait
+#endif
     
 } task_tcb_t;
 
@@ -103,7 +186,11 @@ typedef struct task_tcb {
 #define TASK_FLAG_STATIC        (1 << 0)    // TCB is statically allocated 
 #define TASK_FLAG_STATIC_STACK  (1 << 1)    // Stack is statically allocated 
 #define TASK_FLAG_PRIVILEGED    (1 << 2)    // Runs in privileged mode 
-#define TASK_FLAG_FPU           (1 << 3)    // Uses FPU (for context save) 
+#define TASK_FLAG_FPU           (1 << 3)    // Uses FPU (informational, switch is lazy) 
+#define TASK_FLAG_EDF           (1 << 4)    // Scheduled by deadline (EDF class)
+#define TASK_FLAG_THRESHOLD     (1 << 5)    // Holds its threshold since dispatch
+#define TASK_FLAG_SHARED_STACK  (1 << 6)    // Job task on a stack group
+#define TASK_FLAG_STACK_DROPPED (1 << 7)    // Frame discarded, restart at dispatch
 
 /* 
  * Stack Frame Structures
@@ -139,7 +226,14 @@ typedef struct {
     uint32_t exc_return;    
 } sw_stack_frame_t;
 
-// Extended frame with FPU registers (if FPU context switching enabled) 
+/*
+ * Extended frame with FPU registers
+ *
+ * Pushed by PendSV below the hardware frame and above sw_stack_frame_t,
+ * only when the task's EXC_RETURN has bit 4 clear (it has FP state).
+ * Such a task also carries the 18-word FP part of the hardware frame,
+ * so FPU users need about 136 bytes more stack than integer-only tasks.
+ */
 typedef struct {
     uint32_t s16;
     uint32_t s17;
@@ -190,6 +284,14 @@ uint32_t *task_init_stack(uint32_t *stack_top,
                           void *arg,
                           void (*exit_func)(void));
 
+/*
+ * task_job_restart - Rebuild a shared-stack job task's first frame
+ *
+ * Called at dispatch for a task whose frame was dropped between jobs.
+ */
+
+void task_job_restart(task_tcb_t *tcb);
+
 // Static Task/Stack Allocation Macros
 
 // Declare a static task with its stack 
@@ -205,4 +307,27 @@ uint32_t *task_init_stack(uint32_t *stack_top,
 #define TASK_STATIC_STACK(name) (name##_stack)
 #define TASK_STATIC_STACK_SIZE(name) (sizeof(name##_stack))
 
+/*
+ * Stack group: one stack shared by run-to-completion job tasks that
+ * never preempt each other (Stack Resource Policy). Every member runs
+ * with the group threshold, so the stack is only in use by one job at
+ * a time.
+ */
+typedef struct {
+    uint32_t *stack;
+    uint32_t size;                  // Bytes
+    uint8_t threshold;              // Preemption threshold of all members
+} task_stack_group_t;
+
+// Declare a stack group with its stack
+#define TASK_STACK_GROUP_DEFINE(name, stack_size_bytes, threshold_prio)     \
+    static uint32_t name##_group_stack[(stack_size_bytes) / sizeof(uint32_t)] \
+        __attribute__((section(".task_stacks"), aligned(8)));               \
+    static task_stack_group_t name##_group = {                              \
+        name##_group_stack, sizeof(name##_group_stack), (threshold_prio)    \
+    }
+
+// Get stack group pointer
+#define TASK_STACK_GROUP(name)  (&name##_group)
+
 #endif // TASK_H 
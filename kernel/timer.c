@@ -7,37 +7,208 @@
 #include "timer.h"
 #include "kernel.h"
 #include "sync/critical.h"
+#include "sync/notify.h"
 
-static sw_timer_t *g_timer_list = NULL;
+// The cyclic executive has no tasks: callbacks stay in the tick there
+#define TIMER_USE_DAEMON        (CONFIG_SW_TIMERS && CONFIG_TIMER_DAEMON && \
+                                 !CONFIG_CYCLIC_EXECUTIVE)
 
-static void timer_list_remove(sw_timer_t *timer)
+/*
+ * Timing wheel: TIMER_WHEEL_LEVELS levels of 64 buckets. Level 0 holds
+ * timers due within 64 ticks, one bucket per tick; each level above
+ * covers 64 times the span of the one below. Every 64 ticks the next
+ * bucket of level 1 is cascaded (re-inserted) into level 0, and so on
+ * upward, so a timer is moved at most once per level. Timeouts beyond
+ * the top level's span are parked in its furthest bucket and re-sorted
+ * when that bucket cascades.
+ */
+#define TIMER_WHEEL_BITS        6
+#define TIMER_WHEEL_SIZE        (1U << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK        (TIMER_WHEEL_SIZE - 1U)
+#define TIMER_WHEEL_LEVELS      4
+
+// Longest delta the top level can sort (2^24 ticks)
+#define TIMER_WHEEL_SPAN        (1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+static sw_timer_t *g_wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SIZE];
+
+// Non-empty buckets per level, two words of 32
+static uint32_t g_occupied[TIMER_WHEEL_LEVELS][2];
+
+// Ticks processed by the wheel
+static uint32_t g_wheel_now = 0;
+
+#if TIMER_USE_DAEMON
+// Expired timers waiting for the timer task, in expiry order
+static sw_timer_t *g_due_head = NULL;
+static sw_timer_t **g_due_tail = &g_due_head;
+
+static task_tcb_t g_timer_tcb;
+static uint32_t g_timer_stack[CONFIG_TIMER_STACK_SIZE / sizeof(uint32_t)]
+    __attribute__((section(".task_stacks"), aligned(8)));
+#endif
+
+static inline uint32_t wheel_shift(uint32_t level)
 {
-    sw_timer_t *iter = g_timer_list;
-    sw_timer_t *prev = NULL;
+    return level * TIMER_WHEEL_BITS;
+}
 
-    while (iter != NULL) {
-        if (iter == timer) {
-            if (prev == NULL) {
-                g_timer_list = iter->next;
-            } else {
-                prev->next = iter->next;
+// Caller holds a critical section
+static void wheel_insert(sw_timer_t *timer)
+{
+    uint32_t delta = timer->expires - g_wheel_now;
+    uint32_t sort = timer->expires;
+    uint32_t level = 0;
+    uint32_t slot;
+    sw_timer_t **head;
+
+    if (delta >= TIMER_WHEEL_SPAN) {
+        sort = g_wheel_now + (uint32_t)(TIMER_WHEEL_SPAN - 1U);
+        delta = (uint32_t)(TIMER_WHEEL_SPAN - 1U);
+    }
+    while (delta >= TIMER_WHEEL_SIZE) {
+        delta >>= TIMER_WHEEL_BITS;
+        level++;
+    }
+
+    slot = (sort >> wheel_shift(level)) & TIMER_WHEEL_MASK;
+    head = &g_wheel[level][slot];
+
+    timer->next = *head;
+    if (*head != NULL) {
+        (*head)->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+    timer->bucket = (uint16_t)((level << TIMER_WHEEL_BITS) | slot);
+    g_occupied[level][slot >> 5] |= 1UL << (slot & 31U);
+    timer->active = 1;
+}
+
+// Caller holds a critical section
+static void wheel_remove(sw_timer_t *timer)
+{
+    uint32_t level = (uint32_t)timer->bucket >> TIMER_WHEEL_BITS;
+    uint32_t slot = (uint32_t)timer->bucket & TIMER_WHEEL_MASK;
+
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+    if (g_wheel[level][slot] == NULL) {
+        g_occupied[level][slot >> 5] &= ~(1UL << (slot & 31U));
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->active = 0;
+}
+
+#if TIMER_USE_DAEMON
+// Caller holds a critical section
+static void due_append(sw_timer_t *timer)
+{
+    timer->due_next = NULL;
+    timer->due_pprev = g_due_tail;
+    *g_due_tail = timer;
+    g_due_tail = &timer->due_next;
+    timer->queued = 1;
+}
+
+// Caller holds a critical section
+static void due_remove(sw_timer_t *timer)
+{
+    *timer->due_pprev = timer->due_next;
+    if (timer->due_next != NULL) {
+        timer->due_next->due_pprev = timer->due_pprev;
+    } else {
+        g_due_tail = timer->due_pprev;
+    }
+    timer->due_next = NULL;
+    timer->due_pprev = NULL;
+    timer->queued = 0;
+}
+
+static void timer_task(void *arg)
+{
+    sw_timer_t *timer;
+    timer_callback_t cb;
+    void *cb_arg;
+    uint32_t irq_state;
+
+    (void)arg;
+    for (;;) {
+        (void)task_notify_wait(0, 0, NULL, TIMEOUT_FOREVER);
+
+        for (;;) {
+            irq_state = critical_enter();
+            timer = g_due_head;
+            if (timer == NULL) {
+                critical_exit(irq_state);
+                break;
             }
-            iter->next = NULL;
-            iter->active = 0;
-            return;
+            due_remove(timer);
+            cb = timer->callback;
+            cb_arg = timer->arg;
+            critical_exit(irq_state);
+
+            // Task context: the callback may block. From here on a stop
+            // or restart from a preempting context cannot cancel it
+            cb(cb_arg);
         }
-        prev = iter;
-        iter = iter->next;
     }
 }
+#endif
+
+int timer_init(void)
+{
+#if TIMER_USE_DAEMON
+    return task_create(&g_timer_tcb, "timer", timer_task, NULL,
+                       CONFIG_TIMER_TASK_PRIORITY,
+                       g_timer_stack, sizeof(g_timer_stack));
+#else
+    return KERNEL_OK;
+#endif
+}
 
-static void timer_list_add(sw_timer_t *timer)
+#if CONFIG_SW_TIMERS
+// Take every timer out of a bucket; returns the detached list
+static sw_timer_t *wheel_take(uint32_t level, uint32_t slot)
 {
-    timer->next = g_timer_list;
-    g_timer_list = timer;
-    timer->active = 1;
+    sw_timer_t *list = g_wheel[level][slot];
+
+    g_wheel[level][slot] = NULL;
+    g_occupied[level][slot >> 5] &= ~(1UL << (slot & 31U));
+    return list;
 }
 
+// Re-insert the bucket of @level that g_wheel_now has just reached
+static void wheel_cascade(uint32_t level)
+{
+    sw_timer_t *iter = wheel_take(level, (g_wheel_now >> wheel_shift(level)) & TIMER_WHEEL_MASK);
+    sw_timer_t *next;
+
+    while (iter != NULL) {
+        next = iter->next;
+        wheel_insert(iter);
+        iter = next;
+    }
+}
+
+// Move the wheel one tick forward, cascading upper levels as needed
+static void wheel_step(void)
+{
+    uint32_t level;
+
+    g_wheel_now++;
+    for (level = 1U; level < TIMER_WHEEL_LEVELS; level++) {
+        if (((g_wheel_now >> wheel_shift(level - 1U)) & TIMER_WHEEL_MASK) != 0U) {
+            break;
+        }
+        wheel_cascade(level);
+    }
+}
+#endif
+
 int timer_create(sw_timer_t *timer, timer_callback_t cb, void *arg)
 {
     if (timer == NULL || cb == NULL) {
@@ -45,12 +216,19 @@ int timer_create(sw_timer_t *timer, timer_callback_t cb, void *arg)
     }
 
     timer->period_ticks = 0;
-    timer->remaining_ticks = 0;
+    timer->expires = 0;
     timer->callback = cb;
     timer->arg = arg;
     timer->periodic = 0;
     timer->active = 0;
+    timer->bucket = 0;
     timer->next = NULL;
+    timer->pprev = NULL;
+#if CONFIG_TIMER_DAEMON
+    timer->queued = 0;
+    timer->due_next = NULL;
+    timer->due_pprev = NULL;
+#endif
     return KERNEL_OK;
 }
 
@@ -64,12 +242,18 @@ int timer_start(sw_timer_t *timer, uint32_t period_ticks, uint8_t periodic)
 
     irq_state = critical_enter();
     if (timer->active) {
-        timer_list_remove(timer);
+        wheel_remove(timer);
+    }
+#if TIMER_USE_DAEMON
+    // A restart supersedes an expiry still on the FIFO
+    if (timer->queued) {
+        due_remove(timer);
     }
+#endif
     timer->period_ticks = period_ticks;
-    timer->remaining_ticks = period_ticks;
+    timer->expires = g_wheel_now + period_ticks;
     timer->periodic = periodic ? 1U : 0U;
-    timer_list_add(timer);
+    wheel_insert(timer);
     critical_exit(irq_state);
 
     return KERNEL_OK;
@@ -85,8 +269,15 @@ int timer_stop(sw_timer_t *timer)
 
     irq_state = critical_enter();
     if (timer->active) {
-        timer_list_remove(timer);
+        wheel_remove(timer);
     }
+#if TIMER_USE_DAEMON
+    // Only a callback still on the FIFO can be withdrawn; one the timer
+    // task has already dequeued runs regardless (see timer.h)
+    if (timer->queued) {
+        due_remove(timer);
+    }
+#endif
     critical_exit(irq_state);
 
     return KERNEL_OK;
@@ -100,37 +291,170 @@ int timer_is_active(sw_timer_t *timer)
     return timer->active ? 1 : 0;
 }
 
+#if TIMER_USE_DAEMON
 void timer_tick_isr(void)
 {
-#if CONFIG_SW_TIMERS
-    sw_timer_t *iter = g_timer_list;
+    sw_timer_t *due;
     sw_timer_t *next;
+    uint32_t irq_state;
+    bool queued = false;
 
-    while (iter != NULL) {
-        next = iter->next;
-        if (iter->remaining_ticks > 0U) {
-            iter->remaining_ticks--;
+    irq_state = critical_enter();
+    wheel_step();
+
+    // Bounded work: hand the due bucket to the timer task
+    due = wheel_take(0, g_wheel_now & TIMER_WHEEL_MASK);
+    while (due != NULL) {
+        next = due->next;
+        due->next = NULL;
+        due->pprev = NULL;
+        due->active = 0;
+        if (due->periodic) {
+            due->expires += due->period_ticks;
+            wheel_insert(due);
         }
+        // A periodic timer still queued from its last expiry runs once
+        if (!due->queued) {
+            due_append(due);
+            queued = true;
+        }
+        due = next;
+    }
+    critical_exit(irq_state);
 
-        if (iter->remaining_ticks == 0U) {
-            timer_callback_t cb = iter->callback;
-            void *arg = iter->arg;
+    if (queued) {
+        (void)task_notify_isr(&g_timer_tcb, 0, NOTIFY_NONE);
+    }
+}
+#else
+void timer_tick_isr(void)
+{
+#if CONFIG_SW_TIMERS
+    sw_timer_t *due;
+    sw_timer_t *timer;
+    uint32_t irq_state;
 
-            if (iter->periodic) {
-                iter->remaining_ticks = iter->period_ticks;
-            } else {
-                timer_list_remove(iter);
-            }
+    irq_state = critical_enter();
+    wheel_step();
+
+    // Detach the due bucket so callbacks can start/stop any timer
+    due = wheel_take(0, g_wheel_now & TIMER_WHEEL_MASK);
+    if (due != NULL) {
+        due->pprev = &due;
+    }
+
+    while (due != NULL) {
+        timer_callback_t cb;
+        void *arg;
 
-            /*
-             * Callback executes in SysTick context.
-             * Keep callbacks short and non-blocking.
-             */
-             
-             
-            cb(arg);
+        timer = due;
+        wheel_remove(timer);
+        cb = timer->callback;
+        arg = timer->arg;
+
+        // Periodic timers stay on their period grid
+        if (timer->periodic) {
+            timer->expires += timer->period_ticks;
+            wheel_insert(timer);
         }
-        iter = next;
+        critical_exit(irq_state);
+
+        /*
+         * Callback executes in SysTick context.
+         * Keep callbacks short and non-blocking.
+         */
+
+
+        cb(arg);
+        irq_state = critical_enter();
     }
+    critical_exit(irq_state);
 #endif
 }
+#endif
+
+#if CONFIG_TICKLESS_IDLE
+#if CONFIG_SW_TIMERS
+// Distance from @from to the next non-empty bucket of @level, wrapping
+// (TIMER_WHEEL_SIZE = level empty)
+static uint32_t wheel_next_bucket(uint32_t level, uint32_t from)
+{
+    uint32_t word = from >> 5;
+    uint32_t bits = g_occupied[level][word] & (~0UL << (from & 31U));
+    uint32_t slot;
+
+    if (bits != 0U) {
+        slot = (word << 5) | (uint32_t)__builtin_ctz(bits);
+    } else if (g_occupied[level][word ^ 1U] != 0U) {
+        slot = ((word ^ 1U) << 5) | (uint32_t)__builtin_ctz(g_occupied[level][word ^ 1U]);
+    } else if (g_occupied[level][word] != 0U) {
+        slot = (word << 5) | (uint32_t)__builtin_ctz(g_occupied[level][word]);
+    } else {
+        return TIMER_WHEEL_SIZE;
+    }
+    return (slot - from) & TIMER_WHEEL_MASK;
+}
+#endif
+
+uint32_t timer_next_expiry(void)
+{
+    uint32_t earliest = UINT32_MAX;
+#if CONFIG_SW_TIMERS
+    uint32_t irq_state = critical_enter();
+    uint32_t level, shift, index, dist, ticks;
+
+    // Level 0 is exact; the current bucket was emptied by the last tick
+    dist = wheel_next_bucket(0, g_wheel_now & TIMER_WHEEL_MASK);
+    if (dist < TIMER_WHEEL_SIZE) {
+        earliest = dist;
+    }
+
+    // Above it, nothing fires before its bucket cascades
+    for (level = 1U; level < TIMER_WHEEL_LEVELS; level++) {
+        shift = wheel_shift(level);
+        index = (g_wheel_now >> shift) & TIMER_WHEEL_MASK;
+        dist = wheel_next_bucket(level, index);
+        if (dist == TIMER_WHEEL_SIZE) {
+            continue;
+        }
+        if (dist == 0U) {
+            // Current bucket: it cascaded at the start of this span
+            dist = TIMER_WHEEL_SIZE;
+        }
+        ticks = (((g_wheel_now >> shift) + dist) << shift) - g_wheel_now;
+        if (ticks < earliest) {
+            earliest = ticks;
+        }
+    }
+
+    critical_exit(irq_state);
+#endif
+    return earliest;
+}
+
+void timer_advance(uint32_t ticks)
+{
+#if CONFIG_SW_TIMERS
+    uint32_t irq_state = critical_enter();
+    uint32_t target = g_wheel_now + ticks;
+    sw_timer_t *due;
+    sw_timer_t *next;
+
+    // Never expire here: a timer that is due fires on the next real tick
+    while (g_wheel_now != target) {
+        wheel_step();
+        due = wheel_take(0, g_wheel_now & TIMER_WHEEL_MASK);
+        while (due != NULL) {
+            next = due->next;
+            due->expires = target + 1U;
+            wheel_insert(due);
+            due = next;
+        }
+    }
+
+    critical_exit(irq_state);
+#else
+    (void)ticks;
+#endif
+}
+#endif
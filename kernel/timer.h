@@ -1,24 +1,60 @@
 // HelixRT - Software Timer API
 
+// Timers sit in a hierarchical timing wheel: start, stop and expiry are
+// constant time, and a tick with nothing due touches one empty bucket
+// no matter how many timers are armed. With CONFIG_TIMER_DAEMON the tick
+// only queues due timers and their callbacks run in the timer task.
+
 
 #ifndef TIMER_H
 #define TIMER_H
 
 #include <stdint.h>
+#include "../include/config.h"
+
+#ifndef CONFIG_TIMER_DAEMON
+#define CONFIG_TIMER_DAEMON     0
+#endif
+
+#if CONFIG_TIMER_DAEMON && !CONFIG_TASK_NOTIFY
+#error "CONFIG_TIMER_DAEMON needs CONFIG_TASK_NOTIFY (the tick wakes the timer task by notification)"
+#endif
 
 typedef void (*timer_callback_t)(void *arg);
 
 typedef struct sw_timer {
     uint32_t period_ticks;
-    uint32_t remaining_ticks;
+    uint32_t expires;               // Wheel tick of the next expiry
     timer_callback_t callback;
     void *arg;
     uint8_t periodic;
     uint8_t active;
+    uint16_t bucket;                // Wheel bucket while active
     struct sw_timer *next;
+    struct sw_timer **pprev;        // Link that points at this timer
+#if CONFIG_TIMER_DAEMON
+    uint8_t queued;                 // Callback waiting for the timer task
+    struct sw_timer *due_next;
+    struct sw_timer **due_pprev;
+#endif
 } sw_timer_t;
 
 int timer_create(sw_timer_t *timer, timer_callback_t cb, void *arg);
+
+/*
+ * timer_start - Arm (or re-arm) a timer @period_ticks from now
+ * timer_stop  - Disarm a timer
+ *
+ * Both also withdraw an expiry still waiting on the timer task's FIFO.
+ * An expiry the timer task has already dequeued cannot be withdrawn:
+ * when called from an interrupt, or from a task that preempts the timer
+ * task between the dequeue and the call, the old callback still runs
+ * once after these return. Tasks below CONFIG_TIMER_TASK_PRIORITY and
+ * the callbacks themselves cannot preempt it there and never see this.
+ *
+ * Returns: KERNEL_OK or KERNEL_ERR_PARAM
+ */
+
 int timer_start(sw_timer_t *timer, uint32_t period_ticks, uint8_t periodic);
 int timer_stop(sw_timer_t *timer);
 int timer_is_active(sw_timer_t *timer);
@@ -26,4 +62,21 @@ int timer_is_active(sw_timer_t *timer);
 // Called from SysTick context
 void timer_tick_isr(void);
 
-#endif // TIMER_H 
+/*
+ * timer_init - Create the timer task (called by kernel_init)
+ *
+ * Returns: KERNEL_OK, or the task_create() error
+ */
+
+int timer_init(void);
+
+#if CONFIG_TICKLESS_IDLE
+// Ticks until the earliest active timer fires, or until the wheel has
+// to cascade, whichever is first (UINT32_MAX = none)
+uint32_t timer_next_expiry(void);
+
+// Credit ticks skipped while the tick was stopped
+void timer_advance(uint32_t ticks);
+#endif
+
+#endif // TIMER_H
@@ -12,6 +12,7 @@
 #include "../include/helixrt.h"
 
 #define LED_PIN 3U
+#define BLINK_PERIOD_TICKS ((500U * CONFIG_TICK_RATE_HZ) / 1000U)
 
 TASK_STATIC_DEFINE(blink, 1024);
 TASK_STATIC_DEFINE(heartbeat, 1024);
@@ -29,10 +30,13 @@ static void board_gpio_init(void)
 
 static void blink_task(void *arg)
 {
+    uint32_t last_wake = kernel_get_tick();
+
     (void)arg;
     while (1) {
         gpio_toggle(GPIO2, LED_PIN);
-        task_delay_ms(500);
+        // Fixed phase: the toggle time does not add up as drift
+        (void)task_delay_until(&last_wake, BLINK_PERIOD_TICKS);
     }
 }
 
@@ -46,6 +46,7 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 void Default_Handler(void);
+void GPT2_IRQHandler(void);
 
 extern int main(void);
 
@@ -390,94 +391,94 @@ void (* const vector_table[])(void) = {
     Default_Handler,        /* 69: ADC1 */
     Default_Handler,        /* 70: ADC2 */
     Default_Handler,        /* 71: DCDC */
-    Default_Handler,        /* 72: Reserved */
-    Default_Handler,        /* 73: Reserved */
-    Default_Handler,        /* 74: GPIO1_INT0 */
-    Default_Handler,        /* 75: GPIO1_INT1 */
-    Default_Handler,        /* 76: GPIO1_INT2 */
-    Default_Handler,        /* 77: GPIO1_INT3 */
-    Default_Handler,        /* 78: GPIO1_INT4 */
-    Default_Handler,        /* 79: GPIO1_INT5 */
-    Default_Handler,        /* 80: GPIO1_INT6 */
-    Default_Handler,        /* 81: GPIO1_INT7 */
-    Default_Handler,        /* 82: GPIO1_Combined_0_15 */
-    Default_Handler,        /* 83: GPIO1_Combined_16_31 */
-    Default_Handler,        /* 84: GPIO2_Combined_0_15 */
-    Default_Handler,        /* 85: GPIO2_Combined_16_31 */
-    Default_Handler,        /* 86: GPIO3_Combined_0_15 */
-    Default_Handler,        /* 87: GPIO3_Combined_16_31 */
-    Default_Handler,        /* 88: GPIO4_Combined_0_15 */
-    Default_Handler,        /* 89: GPIO4_Combined_16_31 */
-    Default_Handler,        /* 90: GPIO5_Combined_0_15 */
-    Default_Handler,        /* 91: GPIO5_Combined_16_31 */
-    Default_Handler,        /* 92: FlexIO1 */
-    Default_Handler,        /* 93: FlexIO2 */
-    Default_Handler,        /* 94: WDOG1 */
-    Default_Handler,        /* 95: RTWDOG */
-    Default_Handler,        /* 96: EWM */
-    Default_Handler,        /* 97: CCM_1 */
-    Default_Handler,        /* 98: CCM_2 */
-    Default_Handler,        /* 99: GPC */
-    Default_Handler,        /* 100: SRC */
-    Default_Handler,        /* 101: Reserved */
-    Default_Handler,        /* 102: GPT1 */
-    Default_Handler,        /* 103: GPT2 */
-    Default_Handler,        /* 104: PWM1_0 */
-    Default_Handler,        /* 105: PWM1_1 */
-    Default_Handler,        /* 106: PWM1_2 */
-    Default_Handler,        /* 107: PWM1_3 */
-    Default_Handler,        /* 108: PWM1_FAULT */
-    Default_Handler,        /* 109: FlexSPI2 */
-    Default_Handler,        /* 110: FlexSPI */
-    Default_Handler,        /* 111: SEMC */
-    Default_Handler,        /* 112: USDHC1 */
-    Default_Handler,        /* 113: USDHC2 */
-    Default_Handler,        /* 114: USB_OTG2 */
-    Default_Handler,        /* 115: USB_OTG1 */
-    Default_Handler,        /* 116: ENET */
-    Default_Handler,        /* 117: ENET_1588_Timer */
-    Default_Handler,        /* 118: XBAR1_IRQ_0_1 */
-    Default_Handler,        /* 119: XBAR1_IRQ_2_3 */
-    Default_Handler,        /* 120: ADC_ETC_IRQ0 */
-    Default_Handler,        /* 121: ADC_ETC_IRQ1 */
-    Default_Handler,        /* 122: ADC_ETC_IRQ2 */
-    Default_Handler,        /* 123: ADC_ETC_ERROR_IRQ */
-    Default_Handler,        /* 124: PIT */
-    Default_Handler,        /* 125: ACMP1 */
-    Default_Handler,        /* 126: ACMP2 */
-    Default_Handler,        /* 127: ACMP3 */
-    Default_Handler,        /* 128: ACMP4 */
-    Default_Handler,        /* 129: Reserved */
-    Default_Handler,        /* 130: Reserved */
-    Default_Handler,        /* 131: ENC1 */
-    Default_Handler,        /* 132: ENC2 */
-    Default_Handler,        /* 133: ENC3 */
-    Default_Handler,        /* 134: ENC4 */
-    Default_Handler,        /* 135: TMR1 */
-    Default_Handler,        /* 136: TMR2 */
-    Default_Handler,        /* 137: TMR3 */
-    Default_Handler,        /* 138: TMR4 */
-    Default_Handler,        /* 139: PWM2_0 */
-    Default_Handler,        /* 140: PWM2_1 */
-    Default_Handler,        /* 141: PWM2_2 */
-    Default_Handler,        /* 142: PWM2_3 */
-    Default_Handler,        /* 143: PWM2_FAULT */
-    Default_Handler,        /* 144: PWM3_0 */
-    Default_Handler,        /* 145: PWM3_1 */
-    Default_Handler,        /* 146: PWM3_2 */
-    Default_Handler,        /* 147: PWM3_3 */
-    Default_Handler,        /* 148: PWM3_FAULT */
-    Default_Handler,        /* 149: PWM4_0 */
-    Default_Handler,        /* 150: PWM4_1 */
-    Default_Handler,        /* 151: PWM4_2 */
-    Default_Handler,        /* 152: PWM4_3 */
-    Default_Handler,        /* 153: PWM4_FAULT */
-    Default_Handler,        /* 154: ENET2 */
-    Default_Handler,        /* 155: ENET2_1588_Timer */
-    Default_Handler,        /* 156: CAN3 */
-    Default_Handler,        /* 157: Reserved */
-    Default_Handler,        /* 158: FlexIO3 */
-    Default_Handler,        /* 159: GPIO6_7_8_9 */
+    Default_Handler,        /* 72: GPIO1_INT0 */
+    Default_Handler,        /* 73: GPIO1_INT1 */
+    Default_Handler,        /* 74: GPIO1_INT2 */
+    Default_Handler,        /* 75: GPIO1_INT3 */
+    Default_Handler,        /* 76: GPIO1_INT4 */
+    Default_Handler,        /* 77: GPIO1_INT5 */
+    Default_Handler,        /* 78: GPIO1_INT6 */
+    Default_Handler,        /* 79: GPIO1_INT7 */
+    Default_Handler,        /* 80: GPIO1_Combined_0_15 */
+    Default_Handler,        /* 81: GPIO1_Combined_16_31 */
+    Default_Handler,        /* 82: GPIO2_Combined_0_15 */
+    Default_Handler,        /* 83: GPIO2_Combined_16_31 */
+    Default_Handler,        /* 84: GPIO3_Combined_0_15 */
+    Default_Handler,        /* 85: GPIO3_Combined_16_31 */
+    Default_Handler,        /* 86: GPIO4_Combined_0_15 */
+    Default_Handler,        /* 87: GPIO4_Combined_16_31 */
+    Default_Handler,        /* 88: GPIO5_Combined_0_15 */
+    Default_Handler,        /* 89: GPIO5_Combined_16_31 */
+    Default_Handler,        /* 90: FlexIO1 */
+    Default_Handler,        /* 91: FlexIO2 */
+    Default_Handler,        /* 92: WDOG1 */
+    Default_Handler,        /* 93: RTWDOG */
+    Default_Handler,        /* 94: EWM */
+    Default_Handler,        /* 95: CCM_1 */
+    Default_Handler,        /* 96: CCM_2 */
+    Default_Handler,        /* 97: GPC */
+    Default_Handler,        /* 98: SRC */
+    Default_Handler,        /* 99: Reserved */
+    Default_Handler,        /* 100: GPT1 */
+    GPT2_IRQHandler,        /* 101: GPT2 */
+    Default_Handler,        /* 102: PWM1_0 */
+    Default_Handler,        /* 103: PWM1_1 */
+    Default_Handler,        /* 104: PWM1_2 */
+    Default_Handler,        /* 105: PWM1_3 */
+    Default_Handler,        /* 106: PWM1_FAULT */
+    Default_Handler,        /* 107: FlexSPI2 */
+    Default_Handler,        /* 108: FlexSPI */
+    Default_Handler,        /* 109: SEMC */
+    Default_Handler,        /* 110: USDHC1 */
+    Default_Handler,        /* 111: USDHC2 */
+    Default_Handler,        /* 112: USB_OTG2 */
+    Default_Handler,        /* 113: USB_OTG1 */
+    Default_Handler,        /* 114: ENET */
+    Default_Handler,        /* 115: ENET_1588_Timer */
+    Default_Handler,        /* 116: XBAR1_IRQ_0_1 */
+    Default_Handler,        /* 117: XBAR1_IRQ_2_3 */
+    Default_Handler,        /* 118: ADC_ETC_IRQ0 */
+    Default_Handler,        /* 119: ADC_ETC_IRQ1 */
+    Default_Handler,        /* 120: ADC_ETC_IRQ2 */
+    Default_Handler,        /* 121: ADC_ETC_ERROR_IRQ */
+    Default_Handler,        /* 122: PIT */
+    Default_Handler,        /* 123: ACMP1 */
+    Default_Handler,        /* 124: ACMP2 */
+    Default_Handler,        /* 125: ACMP3 */
+    Default_Handler,        /* 126: ACMP4 */
+    Default_Handler,        /* 127: Reserved */
+    Default_Handler,        /* 128: Reserved */
+    Default_Handler,        /* 129: ENC1 */
+    Default_Handler,        /* 130: ENC2 */
+    Default_Handler,        /* 131: ENC3 */
+    Default_Handler,        /* 132: ENC4 */
+    Default_Handler,        /* 133: TMR1 */
+    Default_Handler,        /* 134: TMR2 */
+    Default_Handler,        /* 135: TMR3 */
+    Default_Handler,        /* 136: TMR4 */
+    Default_Handler,        /* 137: PWM2_0 */
+    Default_Handler,        /* 138: PWM2_1 */
+    Default_Handler,        /* 139: PWM2_2 */
+    Default_Handler,        /* 140: PWM2_3 */
+    Default_Handler,        /* 141: PWM2_FAULT */
+    Default_Handler,        /* 142: PWM3_0 */
+    Default_Handler,        /* 143: PWM3_1 */
+    Default_Handler,        /* 144: PWM3_2 */
+    Default_Handler,        /* 145: PWM3_3 */
+    Default_Handler,        /* 146: PWM3_FAULT */
+    Default_Handler,        /* 147: PWM4_0 */
+    Default_Handler,        /* 148: PWM4_1 */
+    Default_Handler,        /* 149: PWM4_2 */
+    Default_Handler,        /* 150: PWM4_3 */
+    Default_Handler,        /* 151: PWM4_FAULT */
+    Default_Handler,        /* 152: ENET2 */
+    Default_Handler,        /* 153: ENET2_1588_Timer */
+    Default_Handler,        /* 154: CAN3 */
+    Default_Handler,        /* 155: Reserved */
+    Default_Handler,        /* 156: FlexIO3 */
+    Default_Handler,        /* 157: GPIO6_7_8_9 */
+    Default_Handler,        /* 158: Reserved */
+    Default_Handler,        /* 159: Reserved */
 };
 
 /* ============================================================================
@@ -551,9 +552,14 @@ void Reset_Handler(void)
      * Enable FPU (Cortex-M7 has FPU)
      * Set CP10 and CP11 to Full Access (0b11 each)
      * This must be done early, before any floating-point code runs.
+     *
+     * ASPEN + LSPEN: a context only gets an extended (FP) exception frame
+     * once it has executed an FP instruction, and s0-s15 are written to
+     * it lazily. PendSV keys its s16-s31 save off EXC_RETURN bit 4, so
+     * tasks that never touch the FPU carry no FP state at all.
      */
-    #define SCB_CPACR   (*(volatile uint32_t *)0xE000ED88UL)
-    SCB_CPACR |= (0xFUL << 20);  /* Enable CP10 and CP11 */
+    SCB_CPACR |= SCB_CPACR_CP10_CP11;  /* Enable CP10 and CP11 */
+    FPU_FPCCR |= FPU_FPCCR_ASPEN | FPU_FPCCR_LSPEN;
     __DSB();
     __ISB();
     
@@ -646,3 +652,9 @@ __attribute__((weak)) void Default_Handler(void)
 {
     while (1);
 }
+
+/* Not used by the kernel: let threaded IRQ routing see the line */
+__attribute__((weak)) void GPT2_IRQHandler(void)
+{
+    Default_Handler();
+}
@@ -0,0 +1,47 @@
+// HelixRT - Priority lookup cost
+//
+// Mean scheduler_get_next() time with only the idle task ready, so the
+// lookup has to find the lowest level. Built at 32, 64 and 256
+// priority levels (bench_bitmap, bench_bitmap_64, bench_bitmap_256);
+// with the two-level bitmap the figure should not grow past 64. The
+// program first checks lookups across several 32-level groups.
+
+
+#include "host/common.h"
+
+#define LOOKUPS         10000000U
+
+int main(void)
+{
+    const uint8_t prios[] = {
+        CONFIG_MAX_PRIORITY - 2, CONFIG_MAX_PRIORITY / 2 + 1,
+        CONFIG_MAX_PRIORITY / 2 - 1, 0,
+    };
+    volatile uintptr_t sink = 0;
+    double t0, t1;
+    uint32_t i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+
+    // Each new task is above the current highest level
+    for (i = 0; i < sizeof(prios); i++) {
+        (void)mk((int)i, prios[i]);
+        CHECK(scheduler_get_next() == &tcbs[i]);
+    }
+    for (i = sizeof(prios); i-- > 1U; ) {
+        CHECK(task_delete(&tcbs[i]) == KERNEL_OK);
+        CHECK(scheduler_get_next() == &tcbs[i - 1U]);
+    }
+    CHECK(task_delete(&tcbs[0]) == KERNEL_OK);
+    CHECK(scheduler_get_next()->priority == CONFIG_MAX_PRIORITY - 1);
+
+    t0 = host_ns();
+    for (i = 0; i < LOOKUPS; i++) {
+        sink += (uintptr_t)scheduler_get_next();
+    }
+    t1 = host_ns();
+
+    printf("MAX_PRIORITY %3d: %.2f ns/lookup\n", CONFIG_MAX_PRIORITY,
+           (t1 - t0) / LOOKUPS);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// HelixRT - Semaphore ping-pong
+//
+// Two equal-priority tasks hand a semaphore pair back and forth. Per
+// round this counts the critical sections and PendSV requests of the
+// give and of the blocking take, including the retry that takes the
+// unit after the wakeup, and times the round with the PendSV selection.
+// PendSV requests are counted through host_pends (see HOSTSED in the
+// Makefile).
+
+
+#include "host/common.h"
+
+#define ROUNDS          1000000U
+
+uint32_t host_pends;
+
+int main(void)
+{
+    semaphore_t sa, sb;
+    semaphore_t *mine, *other;
+    task_tcb_t *a, *b, *me;
+    uint32_t give_crit = 0, take_crit = 0, give_pends = 0, take_pends = 0;
+    uint32_t c0, c1, p0, p1, i;
+    double t0, t1;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&sa, 0, 0) == KERNEL_OK);
+    CHECK(sem_init(&sb, 0, 0) == KERNEL_OK);
+    a = mk(0, 5);
+    b = mk(1, 5);
+    current_task = a;
+    a->state = TASK_STATE_RUNNING;
+
+    t0 = host_ns();
+    for (i = 0; i < ROUNDS; i++) {
+        me = current_task;
+        mine = (me == a) ? &sa : &sb;
+        other = (me == a) ? &sb : &sa;
+
+        c0 = host_crit;
+        p0 = host_pends;
+        CHECK(sem_give(other) == KERNEL_OK);
+        c1 = host_crit;
+        p1 = host_pends;
+        give_crit += c1 - c0;
+        give_pends += p1 - p0;
+
+        // Returns at the switch point; the wakeup is the partner's give
+        (void)scheduler_block_on(BLOCK_SEMAPHORE, mine, &mine->wait_list_head,
+                                 &mine->wait_list_tail, TIMEOUT_FOREVER);
+        take_crit += host_crit - c1;
+        take_pends += host_pends - p1;
+
+        CHECK(pendsv() == ((me == a) ? b : a));
+
+        // The woken take goes round its loop and takes the unit
+        me = current_task;
+        c0 = host_crit;
+        CHECK(sem_take((me == a) ? &sa : &sb, TIMEOUT_NONE) == KERNEL_OK);
+        take_crit += host_crit - c0;
+    }
+    t1 = host_ns();
+
+    printf("give: %.2f crit, %.2f pends; blocking take: %.2f crit, %.2f pends\n",
+           (double)give_crit / ROUNDS, (double)give_pends / ROUNDS,
+           (double)take_crit / ROUNDS, (double)take_pends / ROUNDS);
+    printf("%.1f ns/round\n", (t1 - t0) / ROUNDS);
+    return 0;
+}
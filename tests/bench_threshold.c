@@ -0,0 +1,171 @@
+// HelixRT - Preemption thresholds and shared stacks
+//
+// A six-stage notify pipeline, later stages at higher priority, fed
+// every 20 ticks for 2000 ticks. Reports context switches per item as
+// plain tasks, plain tasks under a common threshold, and a shared
+// stack group, each with and without a top-priority intruder that
+// preempts jobs. Group jobs must never overlap on the stack. Each
+// variant runs in its own process so it starts from a fresh kernel.
+
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include "host/uctx.h"
+
+#define STAGES          6
+#define RUN_TICKS       2000U
+
+enum { PLAIN, THRESHOLD, SHARED };
+
+// Made visible by HOSTSED in the Makefile
+void shared_job_entry(void *arg);
+
+TASK_STACK_GROUP_DEFINE(pipe, 512, 4);
+
+static task_tcb_t *g_stage[STAGES];
+static uint32_t g_switches, g_items, g_in_job, g_max_in_job;
+static void *g_seen_sp[HOST_MAX_CONTEXTS];
+
+static void job(void *arg)
+{
+    int i = (int)(uintptr_t)arg;
+
+    g_in_job++;
+    if (g_in_job > g_max_in_job) {
+        g_max_in_job = g_in_job;
+    }
+    host_work(1);
+    g_in_job--;
+    if (i + 1 < STAGES) {
+        (void)task_notify(g_stage[i + 1], 0, NOTIFY_NONE);
+    } else {
+        g_items++;
+    }
+}
+
+static void stage_task(void *arg)
+{
+    for (;;) {
+        (void)task_notify_wait(0, NOTIFY_CLEAR_ALL, NULL, TIMEOUT_FOREVER);
+        job(arg);
+    }
+}
+
+static void producer(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        (void)task_notify(g_stage[0], 0, NOTIFY_NONE);
+        task_delay(20);
+    }
+}
+
+static void intruder(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        host_work(1);
+        task_delay(7);
+    }
+}
+
+// host_run() with switch counting; a shared job restarted by the
+// kernel (new frame at the group stack top) gets a fresh context
+static void run(uint32_t ticks)
+{
+    uint32_t end = host_now + ticks;
+    task_tcb_t *prev = NULL, *next;
+    int i;
+
+    host_switch_hook = host_hook;
+    while (host_now < end) {
+        HOST_ICSR &= ~HOST_PENDSVSET;
+        next = pendsv();
+        if (next != prev) {
+            g_switches++;
+            prev = next;
+        }
+        if (next == NULL || strcmp(next->name, "idle") == 0) {
+            host_tick();
+            host_now++;
+            continue;
+        }
+        i = host_context(next);
+        if ((next->flags & TASK_FLAG_SHARED_STACK) && (void *)next->sp != g_seen_sp[i]) {
+            g_seen_sp[i] = next->sp;
+            getcontext(&host_ctx[i]);
+            host_ctx[i].uc_stack.ss_sp = host_stack[i];
+            host_ctx[i].uc_stack.ss_size = HOST_STACK_SIZE;
+            host_ctx[i].uc_link = &host_main;
+            makecontext(&host_ctx[i], (void (*)(void))shared_job_entry, 1, next->arg);
+        }
+        host_in_task = i;
+        swapcontext(&host_main, &host_ctx[i]);
+        host_in_task = -1;
+    }
+    host_switch_hook = NULL;
+}
+
+static void variant(int mode, int with_intruder)
+{
+    static const char *const names[] = { "plain", "threshold", "shared" };
+    void *arg;
+    int i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    for (i = 0; i < STAGES; i++) {
+        g_stage[i] = &tcbs[i];
+        arg = (void *)(uintptr_t)i;
+        if (mode == SHARED) {
+            CHECK(task_create_shared(&tcbs[i], "s", job, arg, (uint8_t)(10 - i),
+                                     TASK_STACK_GROUP(pipe)) == KERNEL_OK);
+        } else {
+            CHECK(task_create(&tcbs[i], "s", stage_task, arg, (uint8_t)(10 - i),
+                              stacks[i], sizeof(stacks[i])) == KERNEL_OK);
+            if (mode == THRESHOLD) {
+                CHECK(task_set_threshold(&tcbs[i], 4) == KERNEL_OK);
+            }
+        }
+    }
+    if (mode == SHARED) {
+        // Members must sit at or below the group threshold and keep it
+        CHECK(task_create_shared(&tcbs[9], "x", job, NULL, 3,
+                                 TASK_STACK_GROUP(pipe)) == KERNEL_ERR_PARAM);
+        CHECK(task_set_threshold(g_stage[0], 2) == KERNEL_ERR_PARAM);
+    }
+    CHECK(task_create(&tcbs[6], "prod", producer, NULL, 1,
+                      stacks[6], sizeof(stacks[6])) == KERNEL_OK);
+    if (with_intruder) {
+        CHECK(task_create(&tcbs[7], "intr", intruder, NULL, 0,
+                          stacks[7], sizeof(stacks[7])) == KERNEL_OK);
+    }
+
+    run(RUN_TICKS);
+    CHECK(g_items >= RUN_TICKS / 20U - 1U);
+    if (mode == SHARED) {
+        CHECK(g_max_in_job == 1U);
+    }
+    printf("%-9s %-12s %5.2f switches/item\n", names[mode],
+           with_intruder ? "+intruder" : "", (double)g_switches / g_items);
+}
+
+int main(void)
+{
+    int mode, with_intruder, status;
+    pid_t pid;
+
+    for (mode = PLAIN; mode <= SHARED; mode++) {
+        for (with_intruder = 0; with_intruder <= 1; with_intruder++) {
+            fflush(stdout);
+            pid = fork();
+            CHECK(pid >= 0);
+            if (pid == 0) {
+                variant(mode, with_intruder);
+                exit(0);
+            }
+            CHECK(waitpid(pid, &status, 0) == pid);
+            CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+// HelixRT - Tick cost against blocked tasks
+//
+// Mean scheduler_tick() time with 1, 16 and 64 tasks blocked on
+// timeouts that do not expire during the run. With the delta list the
+// tick ages only the head, so the figure should not grow with the
+// number of sleepers. Host nanoseconds, not target cycles.
+
+
+#include "host/common.h"
+
+#define TICKS           1000000U
+#define SLEEP_TICKS     (TICKS * 4U)
+
+static const int g_points[] = { 1, 16, 64 };
+
+int main(void)
+{
+    int created = 0;
+    uint32_t i, p;
+    double t0, t1;
+
+    CHECK(kernel_init() == KERNEL_OK);
+
+    for (p = 0; p < sizeof(g_points) / sizeof(g_points[0]); p++) {
+        // Staggered so every sleeper has its own list entry
+        while (created < g_points[p]) {
+            (void)mk(created, 10);
+            (void)host_block(&tcbs[created], BLOCK_DELAY, NULL, NULL, NULL,
+                             SLEEP_TICKS + (uint32_t)created * 3U);
+            created++;
+        }
+
+        t0 = host_ns();
+        for (i = 0; i < TICKS; i++) {
+            scheduler_tick();
+        }
+        t1 = host_ns();
+
+        for (i = 0; i < (uint32_t)created; i++) {
+            CHECK(tcbs[i].state == TASK_STATE_BLOCKED);
+        }
+        printf("%3d blocked: %.1f ns/tick\n", created, (t1 - t0) / TICKS);
+    }
+    return 0;
+}
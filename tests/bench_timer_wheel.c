@@ -0,0 +1,48 @@
+// HelixRT - Timer tick cost
+//
+// Mean timer_tick_isr() time with 8, 64 and 512 armed periodic timers,
+// none of them due during the run. With the wheel the figure should
+// not grow with the number of timers. Host nanoseconds. Only the timer
+// API is used, so the same program builds against an older tree for
+// comparison: make ROOT=<checkout> BUILD_DIR=build-old bench_timer_wheel
+
+
+#include "host/common.h"
+
+#define MAX_TIMERS      512
+#define TICKS           50000U
+
+static sw_timer_t g_tm[MAX_TIMERS];
+static const int g_points[] = { 8, 64, 512 };
+
+static void cb(void *arg)
+{
+    (void)arg;
+}
+
+int main(void)
+{
+    uint32_t i, p;
+    double t0, t1;
+    int n;
+
+    for (p = 0; p < sizeof(g_points) / sizeof(g_points[0]); p++) {
+        n = g_points[p];
+        for (i = 0; i < (uint32_t)n; i++) {
+            CHECK(timer_create(&g_tm[i], cb, NULL) == KERNEL_OK);
+            CHECK(timer_start(&g_tm[i], 100000U + i * 37U, 1) == KERNEL_OK);
+        }
+
+        t0 = host_ns();
+        for (i = 0; i < TICKS; i++) {
+            timer_tick_isr();
+        }
+        t1 = host_ns();
+        printf("%3d armed: %.1f ns/tick\n", n, (t1 - t0) / TICKS);
+
+        for (i = 0; i < (uint32_t)n; i++) {
+            (void)timer_stop(&g_tm[i]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// HelixRT - Semaphore wake cost against unrelated waiters
+//
+// Mean sem_give() time to wake one task, with 2, 8, 16 and 64 other
+// tasks blocked on other semaphores. A give only walks its own wait
+// queue, so the figure should not grow with the number of unrelated
+// waiters. Host nanoseconds, less the cost of reading the clock.
+
+
+#include "host/common.h"
+
+#define WAKES           1000000U
+
+static const int g_points[] = { 2, 8, 16, 64 };
+
+static semaphore_t g_others[64];
+static uint32_t g_waiter_stack[256];
+static task_tcb_t g_waiter;
+
+int main(void)
+{
+    semaphore_t sem;
+    int created = 0;
+    uint32_t i, p;
+    double t0, t1, clock_ns, total;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&sem, 0, 0) == KERNEL_OK);
+    CHECK(task_create(&g_waiter, "waiter", host_dummy, NULL, 5, g_waiter_stack,
+                      sizeof(g_waiter_stack)) == KERNEL_OK);
+
+    t0 = host_ns();
+    for (i = 0; i < WAKES; i++) {
+        (void)host_ns();
+    }
+    clock_ns = (host_ns() - t0) / WAKES;
+
+    for (p = 0; p < sizeof(g_points) / sizeof(g_points[0]); p++) {
+        while (created < g_points[p]) {
+            semaphore_t *other = &g_others[created];
+
+            CHECK(sem_init(other, 0, 0) == KERNEL_OK);
+            (void)mk(created, 10);
+            (void)host_block(&tcbs[created], BLOCK_SEMAPHORE, other,
+                             &other->wait_list_head, &other->wait_list_tail,
+                             TIMEOUT_FOREVER);
+            created++;
+        }
+
+        total = 0.0;
+        for (i = 0; i < WAKES; i++) {
+            CHECK(host_block(&g_waiter, BLOCK_SEMAPHORE, &sem, &sem.wait_list_head,
+                             &sem.wait_list_tail, TIMEOUT_FOREVER) == KERNEL_OK);
+            t0 = host_ns();
+            (void)sem_give(&sem);
+            t1 = host_ns();
+            total += t1 - t0;
+
+            // The woken take goes round its loop and takes the unit
+            CHECK(g_waiter.state == TASK_STATE_READY);
+            current_task = &g_waiter;
+            CHECK(sem_take(&sem, TIMEOUT_NONE) == KERNEL_OK);
+            current_task = NULL;
+        }
+
+        for (i = 0; i < (uint32_t)created; i++) {
+            CHECK(tcbs[i].state == TASK_STATE_BLOCKED);
+        }
+        printf("%3d blocked: %.1f ns/wake\n", created, total / WAKES - clock_ns);
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+// HelixRT - Yield throughput
+//
+// Mean cost of scheduler_yield() plus the PendSV selection with 2, 8
+// and 16 tasks sharing one priority. Rotation goes through the tail
+// pointer, so the figure should not grow with the queue length. Host
+// nanoseconds, without the register save and restore.
+
+
+#include "host/common.h"
+
+#define YIELDS          1000000U
+
+static const int g_points[] = { 2, 8, 16 };
+
+int main(void)
+{
+    int created = 0;
+    uint32_t i, p;
+    double t0, t1;
+
+    CHECK(kernel_init() == KERNEL_OK);
+
+    for (p = 0; p < sizeof(g_points) / sizeof(g_points[0]); p++) {
+        while (created < g_points[p]) {
+            (void)mk(created, 4);
+            created++;
+        }
+        (void)pendsv();
+
+        t0 = host_ns();
+        for (i = 0; i < YIELDS; i++) {
+            scheduler_yield();
+            (void)pendsv();
+        }
+        t1 = host_ns();
+
+        printf("%3d tasks: %.1f ns/yield\n", created, (t1 - t0) / YIELDS);
+    }
+    return 0;
+}
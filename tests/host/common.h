@@ -0,0 +1,84 @@
+// HelixRT - Host test helpers
+
+
+#ifndef HOST_COMMON_H
+#define HOST_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/helixrt.h"
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);          \
+            exit(1);                                                        \
+        }                                                                   \
+    } while (0)
+
+extern task_tcb_t *current_task;
+void SysTick_Handler(void);
+
+static uint32_t stacks[64][256];
+static task_tcb_t tcbs[64];
+
+static void host_dummy(void *arg)
+{
+    (void)arg;
+}
+
+// What PendSV does, minus the register frames: pick and mark the next task
+static task_tcb_t *pendsv(void)
+{
+    task_tcb_t *prev = current_task;
+    task_tcb_t *next = scheduler_select_next_task(DWT_CYCCNT);
+
+    if (prev != NULL && prev->state == TASK_STATE_RUNNING) {
+        prev->state = TASK_STATE_READY;
+    }
+    current_task = next;
+    if (next != NULL) {
+        next->state = TASK_STATE_RUNNING;
+    }
+    return next;
+}
+
+// Task @i of the static pool at @prio, with an entry that is never run
+static task_tcb_t *mk(int i, uint8_t prio)
+{
+    CHECK(task_create(&tcbs[i], "t", host_dummy, NULL, prio,
+                      stacks[i], sizeof(stacks[i])) == KERNEL_OK);
+    return &tcbs[i];
+}
+
+// Block @tcb as if it were the running task (no switch happens on the host)
+static int host_block(task_tcb_t *tcb, block_reason_t reason, void *object,
+                      task_tcb_t **wait_head, task_tcb_t **wait_tail,
+                      uint32_t timeout)
+{
+    int res;
+
+    current_task = tcb;
+    tcb->state = TASK_STATE_RUNNING;
+    if (wait_head != NULL) {
+        res = scheduler_block_on(reason, object, wait_head, wait_tail, timeout);
+    } else {
+        res = scheduler_block_task(reason, object, timeout);
+    }
+    current_task = NULL;
+    return res;
+}
+
+// Host monotonic clock for benchmarks (mmio.c, clear of the timer_create clash)
+double host_ns(void);
+
+// One SysTick interrupt
+static void host_tick(void)
+{
+    host_isr = 1;
+    SysTick_Handler();
+    host_isr = 0;
+}
+
+#endif // HOST_COMMON_H
@@ -0,0 +1,133 @@
+// HelixRT - Host test memory-mapped I/O
+//
+// Maps the Cortex-M system space and the i.MX RT peripheral windows at
+// their real addresses as ordinary memory, so register accesses in the
+// kernel and HAL compile unchanged and read back what was written.
+
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+uint32_t host_primask;
+uint32_t host_crit;
+int host_isr;
+void (*host_switch_hook)(void);
+void (*host_wfi_hook)(void);
+uint32_t host_ipsr;
+uint32_t host_msp;
+uint32_t host_basepri;
+
+__attribute__((constructor))
+static void host_map_mmio(void)
+{
+    static const uintptr_t regions[][2] = {
+        { 0xE0000000UL, 0x00100000UL },     // PPB: SysTick, NVIC, SCB, DWT
+        { 0x40000000UL, 0x002C0000UL },     // AIPS peripherals
+        { 0x42000000UL, 0x00010000UL },     // Fast GPIO
+    };
+    uint32_t i;
+    void *p;
+
+    for (i = 0; i < sizeof(regions) / sizeof(regions[0]); i++) {
+        p = mmap((void *)regions[i][0], regions[i][1], PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (p != (void *)regions[i][0]) {
+            perror("host_map_mmio");
+            exit(1);
+        }
+    }
+}
+
+double host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint32_t *host_reg(const char *name)
+{
+    if (strcmp(name, "primask") == 0) {
+        return &host_primask;
+    }
+    if (strcmp(name, "basepri") == 0 || strcmp(name, "basepri_max") == 0) {
+        return &host_basepri;
+    }
+    if (strcmp(name, "ipsr") == 0) {
+        return &host_ipsr;
+    }
+    if (strcmp(name, "msp") == 0) {
+        return &host_msp;
+    }
+    return NULL;
+}
+
+static const char *host_next_line(const char *p)
+{
+    p = strchr(p, '\n');
+    return (p != NULL) ? p + 1 : NULL;
+}
+
+/*
+ * Register model behind HOST_REAL_CRITICAL. The Makefile turns each
+ * asm statement of critical.h into a call here; operands keep their
+ * template numbers, and an operand written by mrs is passed by address.
+ * Only mrs, msr and cpsid/cpsie touch the model, the rest are no-ops.
+ */
+void host_asm_ops(const char *insns, ...)
+{
+    uintptr_t op[4] = { 0 };
+    int out[4] = { 0 };
+    char mnemonic[16], reg[16];
+    const char *p;
+    uint32_t *r, value;
+    int n = 0, i;
+    va_list ap;
+
+    for (p = strchr(insns, '%'); p != NULL; p = strchr(p + 1, '%')) {
+        i = p[1] - '0';
+        if (i + 1 > n) {
+            n = i + 1;
+        }
+        if (p - insns >= 4 && strncmp(p - 4, "mrs ", 4) == 0) {
+            out[i] = 1;
+        }
+    }
+    va_start(ap, insns);
+    for (i = 0; i < n; i++) {
+        op[i] = out[i] ? (uintptr_t)va_arg(ap, uint32_t *) : va_arg(ap, uintptr_t);
+    }
+    va_end(ap);
+
+    // One instruction per line of the template
+    for (p = insns; p != NULL; p = host_next_line(p)) {
+        if (sscanf(p, " %15s", mnemonic) != 1) {
+            break;
+        }
+        if (strcmp(mnemonic, "mrs") == 0 &&
+            sscanf(p, " mrs %%%d, %15[a-z_]", &i, reg) == 2 && (r = host_reg(reg)) != NULL) {
+            *(uint32_t *)op[i] = *r;
+        } else if (strcmp(mnemonic, "msr") == 0 &&
+                   sscanf(p, " msr %15[a-z_], %%%d", reg, &i) == 2 && (r = host_reg(reg)) != NULL) {
+            value = (uint32_t)op[i];
+            if (r == &host_basepri) {
+                value &= 0xFFU;
+            }
+            // basepri_max only ever raises the mask: a lower non-zero value
+            if (strcmp(reg, "basepri_max") != 0 ||
+                (value != 0U && (host_basepri == 0U || value < host_basepri))) {
+                *r = value;
+            }
+        } else if (strcmp(mnemonic, "cpsid") == 0) {
+            host_primask = 1;
+        } else if (strcmp(mnemonic, "cpsie") == 0) {
+            host_primask = 0;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+// HelixRT - Host test shim
+//
+// Force-included (-include) ahead of every kernel source in the host
+// build. The Makefile rewrites inline assembly to HOST_ASM(), which is
+// a no-op except for WFI: that calls host_wfi_hook, so a test can let
+// simulated time pass wherever the kernel would sleep. The HAL's
+// register intrinsics are removed from the copied tree (Makefile) and
+// defined here over host variables. Critical
+// sections are a plain flag; leaving the outermost one calls
+// host_switch_hook, the point where a pended PendSV would be taken.
+// Built with HOST_REAL_CRITICAL, the kernel keeps the real critical.h
+// and its asm runs on the register model in host_asm_ops() (mmio.c).
+
+
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern uint32_t host_primask;
+extern uint32_t host_crit;          // Critical sections entered
+extern int host_isr;                // Nonzero while "in" an interrupt
+extern void (*host_switch_hook)(void);
+extern void (*host_wfi_hook)(void);
+extern uint32_t host_ipsr;          // IPSR as seen by __get_IPSR()
+extern uint32_t host_msp;
+extern uint32_t host_basepri;
+
+// Runs @insns on the register model: outputs by address, then inputs
+void host_asm_ops(const char *insns, ...);
+
+static inline void host_asm(const char *insn)
+{
+    // #__VA_ARGS__ keeps the quotes: "\"wfi\""
+    if (host_wfi_hook != NULL &&
+        insn[0] == '"' && insn[1] == 'w' && insn[2] == 'f' && insn[3] == 'i') {
+        host_wfi_hook();
+    }
+}
+
+#define HOST_ASM(...) host_asm(#__VA_ARGS__)
+
+// Replace the HAL's register intrinsics (stripped by the Makefile)
+static inline uint32_t __get_PRIMASK(void)
+{
+    return host_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t value)
+{
+    host_primask = value;
+}
+
+static inline uint32_t __get_MSP(void)
+{
+    return host_msp;
+}
+
+static inline void __set_MSP(uint32_t value)
+{
+    host_msp = value;
+}
+
+static inline uint32_t __get_IPSR(void)
+{
+    return host_ipsr;
+}
+
+#ifndef HOST_REAL_CRITICAL
+// Replaces kernel/sync/critical.h
+#define CRITICAL_H
+
+static inline uint32_t critical_enter(void)
+{
+    uint32_t state = host_primask;
+
+    host_crit++;
+    host_primask = 1;
+    return state;
+}
+
+static inline void critical_exit(uint32_t state)
+{
+    host_primask = state;
+    if (state == 0U && host_switch_hook != NULL) {
+        host_switch_hook();
+    }
+}
+
+static inline uint32_t critical_enter_basepri(uint32_t priority)
+{
+    (void)priority;
+    return critical_enter();
+}
+
+static inline void critical_exit_basepri(uint32_t state)
+{
+    critical_exit(state);
+}
+
+static inline int is_irq_disabled(void)
+{
+    return (int)host_primask;
+}
+
+static inline int is_isr_context(void)
+{
+    return host_isr;
+}
+#endif
+
+#endif // HOST_SHIM_H
@@ -0,0 +1,104 @@
+// HelixRT - Host task switching
+//
+// Runs each kernel task on its own ucontext. host_run() plays PendSV
+// and the idle loop: it asks the scheduler for the next task, swaps to
+// it, and ticks SysTick whenever nothing but idle is ready. Inside a
+// task, a pended switch is taken when the outermost critical section
+// exits (host_switch_hook), which is where the core would take PendSV.
+// host_work() stands in for a task burning CPU time.
+
+
+#ifndef HOST_UCTX_H
+#define HOST_UCTX_H
+
+#include <ucontext.h>
+#include "common.h"
+
+#define HOST_MAX_CONTEXTS   40
+#define HOST_STACK_SIZE     65536
+
+#define HOST_ICSR           (*(volatile uint32_t *)0xE000ED04UL)
+#define HOST_PENDSVSET      (1UL << 28)
+
+static ucontext_t host_main;
+static ucontext_t host_ctx[HOST_MAX_CONTEXTS];
+static char host_stack[HOST_MAX_CONTEXTS][HOST_STACK_SIZE];
+static task_tcb_t *host_tcb[HOST_MAX_CONTEXTS];
+static int host_ntask = 0;
+static int host_in_task = -1;       // Context running now, -1 = host_run()
+static uint32_t host_now = 0;       // Ticks simulated so far
+
+// Context for @tcb, created on first dispatch to run tcb->entry(arg)
+static int host_context(task_tcb_t *tcb)
+{
+    int i;
+
+    for (i = 0; i < host_ntask; i++) {
+        if (host_tcb[i] == tcb) {
+            return i;
+        }
+    }
+    CHECK(host_ntask < HOST_MAX_CONTEXTS);
+    host_tcb[i] = tcb;
+    getcontext(&host_ctx[i]);
+    host_ctx[i].uc_stack.ss_sp = host_stack[i];
+    host_ctx[i].uc_stack.ss_size = HOST_STACK_SIZE;
+    host_ctx[i].uc_link = &host_main;
+    makecontext(&host_ctx[i], (void (*)(void))tcb->entry, 1, tcb->arg);
+    host_ntask++;
+    return i;
+}
+
+// Back to host_run() if the task has pended a switch
+static void host_hook(void)
+{
+    int self = host_in_task;
+
+    if (self >= 0 && !host_isr && (HOST_ICSR & HOST_PENDSVSET)) {
+        host_in_task = -1;
+        swapcontext(&host_ctx[self], &host_main);
+    }
+}
+
+// Simulate @ticks ticks; time only passes while idle or in host_work()
+static void host_run(uint32_t ticks)
+{
+    uint32_t end = host_now + ticks;
+    task_tcb_t *next;
+    int i;
+
+    host_switch_hook = host_hook;
+    while (host_now < end) {
+        HOST_ICSR &= ~HOST_PENDSVSET;
+        next = pendsv();
+        if (next == NULL || strcmp(next->name, "idle") == 0) {
+            host_tick();
+            host_now++;
+            continue;
+        }
+        i = host_context(next);
+        host_in_task = i;
+        swapcontext(&host_main, &host_ctx[i]);
+        host_in_task = -1;
+    }
+    host_switch_hook = NULL;
+}
+
+// From a task: run for @ticks ticks, preempted wherever the tick says so
+static void host_work(uint32_t ticks)
+{
+    int self;
+
+    while (ticks-- > 0U) {
+        self = host_in_task;
+        host_tick();
+        host_now++;
+        host_in_task = self;
+        if (HOST_ICSR & HOST_PENDSVSET) {
+            host_in_task = -1;
+            swapcontext(&host_ctx[self], &host_main);
+        }
+    }
+}
+
+#endif // HOST_UCTX_H
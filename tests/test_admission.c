@@ -0,0 +1,46 @@
+// HelixRT - Admission on deadline changes
+//
+// task_set_deadline() on a task from task_create_periodic() re-runs
+// the admission test with the new timing. A change that would make the
+// set unschedulable is refused and leaves both the task and the
+// admission table as they were.
+
+
+#include "host/common.h"
+
+int main(void)
+{
+    task_tcb_t *a = &tcbs[0], *b = &tcbs[1], *c = &tcbs[2], *plain;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(task_create_periodic(a, "a", host_dummy, NULL, 1, stacks[0],
+                               sizeof(stacks[0]), 5, 0, 2) == KERNEL_OK);
+    CHECK(task_create_periodic(b, "b", host_dummy, NULL, 2, stacks[1],
+                               sizeof(stacks[1]), 10, 0, 2) == KERNEL_OK);
+
+    // b responds in 4 ticks behind a, so a 3-tick deadline is refused
+    CHECK(task_set_deadline(b, 10, 3) == KERNEL_ERR_OVERLOAD);
+    CHECK(b->period == 10U && b->rel_deadline == 10U);
+
+    // A periodic task stays periodic, with a deadline its WCET fits in
+    CHECK(task_set_deadline(b, 0, 5) == KERNEL_ERR_PARAM);
+    CHECK(task_set_deadline(b, 10, 1) == KERNEL_ERR_PARAM);
+    CHECK(task_set_deadline(b, PERIODIC_MAX_TICKS + 1U, 10) == KERNEL_ERR_PARAM);
+
+    // Only fits if the table still holds b's old deadline
+    CHECK(task_create_periodic(c, "c", host_dummy, NULL, 3, stacks[2],
+                               sizeof(stacks[2]), 20, 0, 2) == KERNEL_OK);
+
+    CHECK(task_set_deadline(b, 20, 8) == KERNEL_OK);
+    CHECK(b->period == 20U && b->rel_deadline == 8U);
+    CHECK(task_set_deadline(a, 4, 2) == KERNEL_OK);
+    CHECK(task_set_deadline(a, 2, 2) == KERNEL_ERR_OVERLOAD);
+    CHECK(a->period == 4U && a->rel_deadline == 2U);
+
+    // Tasks outside the admission table are not checked
+    plain = mk(3, 4);
+    CHECK(task_set_deadline(plain, 0, 1) == KERNEL_OK);
+
+    printf("test_admission: ok\n");
+    return 0;
+}
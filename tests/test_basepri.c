@@ -0,0 +1,71 @@
+// HelixRT - BASEPRI critical sections
+//
+// Built against the real kernel/sync/critical.h, with its mrs/msr on a
+// host register model. With CONFIG_KERNEL_MAX_SYSCALL_PRIORITY set,
+// critical_enter() raises BASEPRI instead of setting PRIMASK, nests,
+// never lowers a stronger mask it finds, and critical_exit() restores
+// each level in turn. Interrupts above the syscall level stay live.
+
+
+#include "host/common.h"
+
+#define SYSCALL_MASK    (CONFIG_KERNEL_MAX_SYSCALL_PRIORITY << 4)
+
+// Whether an interrupt at @prio would be taken now
+static int irq_taken(uint32_t prio)
+{
+    return host_primask == 0U && (host_basepri == 0U || (prio << 4) < host_basepri);
+}
+
+int main(void)
+{
+    uint32_t s0, s1, s2, s3;
+    semaphore_t sem;
+    task_tcb_t *t;
+
+    CHECK(CONFIG_KERNEL_MAX_SYSCALL_PRIORITY == 5);
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(host_basepri == 0U && !is_irq_disabled());
+
+    s0 = critical_enter();
+    CHECK(s0 == 0U && host_basepri == SYSCALL_MASK && host_primask == 0U);
+    CHECK(is_irq_disabled());
+    CHECK(irq_taken(4) && !irq_taken(5) && !irq_taken(15));
+
+    // Nested: same level, then a stronger mask that a weaker one keeps
+    s1 = critical_enter();
+    CHECK(s1 == SYSCALL_MASK && host_basepri == SYSCALL_MASK);
+    s2 = critical_enter_basepri(3);
+    CHECK(s2 == SYSCALL_MASK && host_basepri == (3U << 4));
+    CHECK(irq_taken(2) && !irq_taken(4));
+    s3 = critical_enter();
+    CHECK(s3 == (3U << 4) && host_basepri == (3U << 4));
+
+    critical_exit(s3);
+    CHECK(host_basepri == (3U << 4));
+    critical_exit_basepri(s2);
+    CHECK(host_basepri == SYSCALL_MASK);
+    critical_exit(s1);
+    CHECK(host_basepri == SYSCALL_MASK && is_irq_disabled());
+    critical_exit(s0);
+    CHECK(host_basepri == 0U && !is_irq_disabled() && irq_taken(15));
+
+    // Kernel calls nest inside a caller's section and leave it as found
+    CHECK(sem_init(&sem, 1, 1) == KERNEL_OK);
+    t = mk(0, 4);
+    current_task = t;
+    t->state = TASK_STATE_RUNNING;
+    s0 = critical_enter();
+    CHECK(sem_take(&sem, TIMEOUT_NONE) == KERNEL_OK);
+    CHECK(host_basepri == SYSCALL_MASK);
+    // Blocking needs the mask down, so it is refused rather than stuck
+    CHECK(sem_take(&sem, 10) == KERNEL_ERR_STATE);
+    CHECK(host_basepri == SYSCALL_MASK && sem.wait_list_head == NULL);
+    critical_exit(s0);
+    CHECK(host_basepri == 0U);
+    CHECK(sem_give(&sem) == KERNEL_OK && host_basepri == 0U);
+    current_task = NULL;
+
+    printf("test_basepri: ok\n");
+    return 0;
+}
@@ -0,0 +1,106 @@
+// HelixRT - Wake between check and block
+//
+// sem_take(), queue_send(), queue_receive() and event_wait() test their
+// object, leave the critical section, then block. An interrupt that
+// gives, sends, receives or sets in that window finds no waiter yet;
+// the block must see the change and let the call retry rather than
+// sleep out its timeout on an object that is already available.
+
+
+#include "host/uctx.h"
+
+#define WAIT_TICKS      50U
+
+static semaphore_t g_sem;
+static msg_queue_t g_queue;
+static uint32_t g_queue_buf[1];
+static event_group_t g_events;
+static void (*g_inject)(void) = NULL;
+static int g_done = 0;
+
+// Runs g_inject as an interrupt at the next critical-section exit in a task
+static void inject_hook(void)
+{
+    void (*irq)(void) = g_inject;
+
+    if (irq != NULL && host_in_task >= 0) {
+        g_inject = NULL;
+        host_isr = 1;
+        irq();
+        host_isr = 0;
+    }
+    host_hook();
+}
+
+static void give_irq(void)
+{
+    CHECK(sem_give(&g_sem) == KERNEL_OK);
+}
+
+static void send_irq(void)
+{
+    uint32_t msg = 7U;
+
+    CHECK(queue_send_isr(&g_queue, &msg) == KERNEL_OK);
+}
+
+static void receive_irq(void)
+{
+    uint32_t msg;
+
+    CHECK(queue_receive(&g_queue, &msg, TIMEOUT_NONE) == KERNEL_OK);
+    CHECK(msg == 1U);
+}
+
+static void set_irq(void)
+{
+    CHECK(event_set(&g_events, 0x3U) == KERNEL_OK);
+}
+
+static void taker(void *arg)
+{
+    uint32_t start, msg = 0U;
+
+    (void)arg;
+    host_switch_hook = inject_hook;
+
+    start = kernel_get_tick();
+    g_inject = give_irq;
+    CHECK(sem_take(&g_sem, WAIT_TICKS) == KERNEL_OK);
+    CHECK(kernel_get_tick() == start && g_sem.count == 0);
+
+    g_inject = send_irq;
+    CHECK(queue_receive(&g_queue, &msg, WAIT_TICKS) == KERNEL_OK);
+    CHECK(kernel_get_tick() == start && msg == 7U);
+
+    msg = 1U;
+    CHECK(queue_send(&g_queue, &msg, TIMEOUT_NONE) == KERNEL_OK);
+    msg = 2U;
+    g_inject = receive_irq;
+    CHECK(queue_send(&g_queue, &msg, WAIT_TICKS) == KERNEL_OK);
+    CHECK(kernel_get_tick() == start && g_queue.count == 1U);
+
+    g_inject = set_irq;
+    CHECK(event_wait(&g_events, 0x3U, EVENT_WAIT_ALL, WAIT_TICKS) == 0x3U);
+    CHECK(kernel_get_tick() == start);
+
+    CHECK(g_inject == NULL);
+    g_done = 1;
+    (void)task_suspend(NULL);
+}
+
+int main(void)
+{
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&g_sem, 0, 1) == KERNEL_OK);
+    CHECK(queue_init(&g_queue, g_queue_buf, sizeof(uint32_t), 1U) == KERNEL_OK);
+    CHECK(event_init(&g_events) == KERNEL_OK);
+    CHECK(task_create(&tcbs[0], "taker", taker, NULL, 4,
+                      stacks[0], sizeof(stacks[0])) == KERNEL_OK);
+
+    host_run(2U * WAIT_TICKS);
+    CHECK(g_done);
+
+    printf("test_block_race: ok\n");
+    return 0;
+}
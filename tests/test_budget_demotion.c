@@ -0,0 +1,59 @@
+// HelixRT - Budget demotion and effective priority
+//
+// A task demoted for overrunning its CPU budget stays at
+// CONFIG_BUDGET_DEMOTE_PRIORITY whatever it locks or is set to, and
+// the refill restores the ceiling it still holds, not its base.
+
+
+#include "host/common.h"
+
+// @n ticks of @cycles cycles each, switching as PendSV would
+static void run_ticks(int n, uint32_t cycles)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        DWT_CYCCNT += cycles;
+        scheduler_tick();
+        (void)pendsv();
+    }
+}
+
+int main(void)
+{
+    task_tcb_t *a, *b;
+    mutex_t c3, c4;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    DWT_CYCCNT = 0;
+    a = mk(0, 6);
+    b = mk(1, 8);
+    CHECK(mutex_init_ceiling(&c3, 0, 3) == KERNEL_OK);
+    CHECK(mutex_init_ceiling(&c4, 0, 4) == KERNEL_OK);
+
+    CHECK(pendsv() == a);
+    CHECK(mutex_lock(&c4, 0) == KERNEL_OK && a->priority == 4);
+    CHECK(task_set_budget(a, 1000, 10, BUDGET_POLICY_DEMOTE) == KERNEL_OK);
+    run_ticks(2, 600);
+    CHECK(a->budget_depleted && current_task == b);
+    CHECK(a->priority == CONFIG_BUDGET_DEMOTE_PRIORITY);
+
+    // Nothing the demoted task does lifts it before the refill
+    CHECK(task_suspend(b) == KERNEL_OK);
+    CHECK(pendsv() == a);
+    CHECK(mutex_lock(&c3, 0) == KERNEL_OK);
+    CHECK(a->priority == CONFIG_BUDGET_DEMOTE_PRIORITY);
+    CHECK(mutex_unlock(&c3) == KERNEL_OK);
+    CHECK(a->priority == CONFIG_BUDGET_DEMOTE_PRIORITY);
+    CHECK(task_set_priority(a, 2) == KERNEL_OK);
+    CHECK(a->priority == CONFIG_BUDGET_DEMOTE_PRIORITY);
+
+    // The refill restores the ceiling still held
+    run_ticks(10, 0);
+    CHECK(!a->budget_depleted && a->priority == 2);
+    CHECK(task_set_priority(a, 6) == KERNEL_OK && a->priority == 4);
+    CHECK(mutex_unlock(&c4) == KERNEL_OK && a->priority == 6);
+
+    printf("test_budget_demotion: ok\n");
+    return 0;
+}
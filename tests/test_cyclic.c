@@ -0,0 +1,135 @@
+// HelixRT - Cyclic executive release times
+//
+// Runs the real dispatch loop with WFI advancing a simulated SysTick,
+// and checks the tick every table entry starts at across five frames:
+// on time, after one late job (overrun, grid kept), and after a job
+// that runs past a frame boundary (every late slot runs, then the next
+// frame is back on the grid).
+
+
+#include <setjmp.h>
+#include "host/common.h"
+
+#define FRAME_TICKS     10U
+#define FRAMES          5U
+#define ENTRIES         4U
+
+static jmp_buf g_done;
+static uint32_t g_start[FRAMES * ENTRIES];
+static uint32_t g_runs = 0;
+static uint32_t g_late_index[16];
+static uint32_t g_late_ticks[16];
+static uint32_t g_late_count = 0;
+
+// Overrides the weak default in cyclic.c
+void cyclic_overrun_hook(uint32_t index, uint32_t late)
+{
+    g_late_index[g_late_count] = index;
+    g_late_ticks[g_late_count] = late;
+    g_late_count++;
+}
+
+static void burn(uint32_t ticks)
+{
+    while (ticks-- > 0U) {
+        host_tick();
+    }
+}
+
+static void record(void)
+{
+    g_start[g_runs++] = cyclic_get_tick();
+    if (g_runs == FRAMES * ENTRIES) {
+        longjmp(g_done, 1);
+    }
+}
+
+static void job_a(void)
+{
+    record();
+}
+
+static void job_b(void)
+{
+    record();
+    // Frame 1: pushes c 2 ticks past its slot
+    if (g_runs == 6U) {
+        burn(6);
+    }
+}
+
+static void job_c(void)
+{
+    record();
+    // Frame 2: runs on into frame 3
+    if (g_runs == 11U) {
+        burn(15);
+    }
+}
+
+static void job_d(void)
+{
+    record();
+}
+
+CYCLIC_TABLE_DEFINE(g_table,
+    { 0, job_a },
+    { 0, job_b },
+    { 4, job_c },
+    { 7, job_d },
+);
+
+CYCLIC_TABLE_DEFINE(g_unsorted, { 4, job_a }, { 2, job_b });
+CYCLIC_TABLE_DEFINE(g_no_job, { 0, NULL });
+
+static const uint32_t g_expected[FRAMES * ENTRIES] = {
+     0,  0,  4,  7,     // on the grid
+    10, 10, 16, 17,     // c starts 2 late, d is back on time
+    20, 20, 24, 39,     // c overruns into the next frame, d 12 late
+    39, 39, 39, 39,     // the frame's slots all come due: catch-up
+    40, 40, 44, 47,     // back on the grid
+};
+
+int main(void)
+{
+    uint32_t i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+
+    // Table checks
+    CHECK(cyclic_set_table(NULL, 1, FRAME_TICKS) == KERNEL_ERR_PARAM);
+    CHECK(cyclic_set_table(g_table, 0, FRAME_TICKS) == KERNEL_ERR_PARAM);
+    CHECK(cyclic_set_table(g_table, ENTRIES, 7) == KERNEL_ERR_PARAM);
+    CHECK(cyclic_set_table(g_unsorted, 2, FRAME_TICKS) == KERNEL_ERR_PARAM);
+    CHECK(cyclic_set_table(g_no_job, 1, FRAME_TICKS) == KERNEL_ERR_PARAM);
+    CHECK(cyclic_set_table(g_table, ENTRIES, FRAME_TICKS) == KERNEL_OK);
+
+    host_wfi_hook = host_tick;
+    if (setjmp(g_done) == 0) {
+        kernel_start();
+    }
+    host_wfi_hook = NULL;
+
+    for (i = 0; i < FRAMES * ENTRIES; i++) {
+        if (g_start[i] != g_expected[i]) {
+            printf("FAIL entry %u of frame %u started at %u, expected %u\n",
+                   i % ENTRIES, i / ENTRIES, g_start[i], g_expected[i]);
+            return 1;
+        }
+    }
+
+    // One late start in frame 1, five through the overrun
+    CHECK(cyclic_get_overruns() == 6U && g_late_count == 6U);
+    CHECK(g_late_index[0] == 2U && g_late_ticks[0] == 2U);
+    CHECK(g_late_index[1] == 3U && g_late_ticks[1] == 12U);
+    CHECK(g_late_index[2] == 0U && g_late_ticks[2] == 9U);
+    CHECK(g_late_index[3] == 1U && g_late_ticks[3] == 9U);
+    CHECK(g_late_index[4] == 2U && g_late_ticks[4] == 5U);
+    CHECK(g_late_index[5] == 3U && g_late_ticks[5] == 2U);
+
+    // The table is fixed once running
+    CHECK(cyclic_set_table(g_table, ENTRIES, FRAME_TICKS) == KERNEL_ERR_STATE);
+
+    printf("test_cyclic: ok\n");
+    return 0;
+}
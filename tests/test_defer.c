@@ -0,0 +1,124 @@
+// HelixRT - Deferred ISR wakeups
+//
+// With CONFIG_DEFERRED_WAKE, a give or event set from an interrupt
+// updates the object and posts a record; the waiters stay blocked until
+// PendSV drains the ring. A semaphore's count carries the unit, which
+// the woken taker re-takes. A post that finds the ring full wakes
+// directly and is counted, and a nested interrupt between LDREX and
+// STREX makes the outer post retry its claim.
+
+
+#include "host/common.h"
+
+#define WAITERS         6
+
+static void (*g_nested)(void) = NULL;
+
+// STREX; an interrupt taken since LDREX clears the reservation
+int host_strex(uint32_t value, volatile uint32_t *addr)
+{
+    void (*nested)(void) = g_nested;
+
+    if (nested != NULL) {
+        g_nested = NULL;
+        nested();
+        return 1;
+    }
+    *addr = value;
+    return 0;
+}
+
+static semaphore_t g_sems[8];
+
+static void nested_give(void)
+{
+    CHECK(sem_give_isr(&g_sems[1]) == KERNEL_OK);
+}
+
+static void block_on_sem(int i, semaphore_t *sem)
+{
+    CHECK(host_block(&tcbs[i], BLOCK_SEMAPHORE, sem, &sem->wait_list_head,
+                     &sem->wait_list_tail, TIMEOUT_FOREVER) == KERNEL_OK);
+}
+
+int main(void)
+{
+    event_group_t eg;
+    uint32_t c0;
+    int i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(event_init(&eg) == KERNEL_OK);
+    for (i = 0; i < 8; i++) {
+        CHECK(sem_init(&g_sems[i], 0, 0) == KERNEL_OK);
+        (void)mk(i, 5);
+    }
+
+    // One record and one critical section, however many waiters
+    for (i = 0; i < WAITERS; i++) {
+        tcbs[i].event_wait_bits = 0x1U;
+        CHECK(host_block(&tcbs[i], BLOCK_EVENT, &eg, &eg.wait_list_head,
+                         &eg.wait_list_tail, TIMEOUT_FOREVER) == KERNEL_OK);
+    }
+    host_isr = 1;
+    c0 = host_crit;
+    CHECK(event_set(&eg, 0x1U) == KERNEL_OK);
+    host_isr = 0;
+    CHECK(host_crit - c0 == 1U);
+    for (i = 0; i < WAITERS; i++) {
+        CHECK(tcbs[i].state == TASK_STATE_BLOCKED);
+    }
+    defer_drain();
+    for (i = 0; i < WAITERS; i++) {
+        CHECK(tcbs[i].state == TASK_STATE_READY);
+    }
+
+    // The count keeps the unit until the woken taker comes back for it
+    block_on_sem(0, &g_sems[0]);
+    host_isr = 1;
+    CHECK(sem_give_isr(&g_sems[0]) == KERNEL_OK);
+    host_isr = 0;
+    CHECK(tcbs[0].state == TASK_STATE_BLOCKED && g_sems[0].count == 1);
+    defer_drain();
+    CHECK(tcbs[0].state == TASK_STATE_READY);
+    current_task = &tcbs[0];
+    CHECK(sem_take(&g_sems[0], TIMEOUT_NONE) == KERNEL_OK);
+    current_task = NULL;
+    CHECK(g_sems[0].count == 0);
+
+    // A nested give between LDREX and STREX: both posts land
+    block_on_sem(0, &g_sems[0]);
+    block_on_sem(1, &g_sems[1]);
+    g_nested = nested_give;
+    host_isr = 1;
+    CHECK(sem_give_isr(&g_sems[0]) == KERNEL_OK);
+    host_isr = 0;
+    CHECK(g_nested == NULL);
+    CHECK(tcbs[0].state == TASK_STATE_BLOCKED && tcbs[1].state == TASK_STATE_BLOCKED);
+    defer_drain();
+    CHECK(tcbs[0].state == TASK_STATE_READY && tcbs[1].state == TASK_STATE_READY);
+    CHECK(defer_get_overflows() == 0U);
+
+    // Ring full: the post after CONFIG_DEFER_RING_DEPTH wakes directly
+    for (i = 0; i <= CONFIG_DEFER_RING_DEPTH; i++) {
+        g_sems[i].count = 0;
+        block_on_sem(i, &g_sems[i]);
+    }
+    host_isr = 1;
+    for (i = 0; i <= CONFIG_DEFER_RING_DEPTH; i++) {
+        CHECK(sem_give_isr(&g_sems[i]) == KERNEL_OK);
+    }
+    host_isr = 0;
+    for (i = 0; i < CONFIG_DEFER_RING_DEPTH; i++) {
+        CHECK(tcbs[i].state == TASK_STATE_BLOCKED);
+    }
+    CHECK(tcbs[CONFIG_DEFER_RING_DEPTH].state == TASK_STATE_READY);
+    CHECK(defer_get_overflows() == 1U);
+    defer_drain();
+    for (i = 0; i <= CONFIG_DEFER_RING_DEPTH; i++) {
+        CHECK(tcbs[i].state == TASK_STATE_READY);
+    }
+
+    printf("test_defer: ok\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+// HelixRT - task_delay_until() grid and release lateness
+//
+// A loop that works 3 ticks per 10-tick period wakes exactly on the
+// grid. An overrun past one release returns KERNEL_ERR_TIMEOUT, skips
+// to the latest grid point not in the future and counts every release
+// it missed. Each wake records its lateness from the release, in
+// cycles, into the log2 histogram; lateness beyond the last bucket
+// lands in it.
+
+
+#include "host/uctx.h"
+
+#define CORE_HZ         600000000UL
+#define TICK_CYCLES     (CORE_HZ / CONFIG_TICK_RATE_HZ)
+#define WAKE_CYCLES     1000U           // From the tick to the task running
+
+extern volatile uint32_t SystemCoreClock;
+
+static uint32_t g_wake[16];
+static int g_result[16];
+static int g_passes = 0;
+static uint32_t g_last_after_miss = 0;
+
+// The tick's own time after it re-anchors the time base
+void kernel_tick_hook(void)
+{
+    DWT_CYCCNT += WAKE_CYCLES;
+}
+
+static void loop(void *arg)
+{
+    uint32_t last = kernel_get_tick();
+
+    (void)arg;
+    CHECK(task_delay_until(&last, 0) == KERNEL_ERR_PARAM);
+    for (;;) {
+        g_result[g_passes] = task_delay_until(&last, 10);
+        g_wake[g_passes++] = kernel_get_tick();
+        if (g_passes == 4) {
+            // Overruns the release at 50
+            host_work(25);
+        } else {
+            if (g_passes == 5) {
+                g_last_after_miss = last;
+            }
+            host_work(3);
+        }
+        if (g_passes == 8) {
+            (void)task_suspend(NULL);
+        }
+    }
+}
+
+int main(void)
+{
+    static const uint32_t expect[] = { 10, 20, 30, 40, 65, 70, 80, 90 };
+    task_tcb_t *t;
+    int i;
+
+    SystemCoreClock = CORE_HZ;
+    CHECK(kernel_init() == KERNEL_OK);
+    t = mk(0, 3);
+    t->entry = loop;
+
+    host_run(200);
+    CHECK(g_passes == 8);
+    for (i = 0; i < g_passes; i++) {
+        CHECK(g_wake[i] == expect[i]);
+        CHECK(g_result[i] == ((i == 4) ? KERNEL_ERR_TIMEOUT : KERNEL_OK));
+    }
+    // Missed 50 and 60; back on the grid at 60
+    CHECK(g_last_after_miss == 60U && t->release_misses == 2U);
+
+    // On time: WAKE_CYCLES, in [2^9, 2^10) = bucket 4
+    CHECK(t->jitter_hist[4] == 7U);
+    CHECK(t->jitter_max == 5U * TICK_CYCLES + WAKE_CYCLES);
+    CHECK(t->jitter_hist[CONFIG_JITTER_HIST_BUCKETS - 1] == 1U);
+
+    printf("test_delay_until: ok\n");
+    return 0;
+}
@@ -0,0 +1,113 @@
+// HelixRT - EDF ready heap and deadline misses
+//
+// With CONFIG_EDF, ready tasks at CONFIG_EDF_PRIORITY are picked in
+// order of absolute deadline, including after one is taken out of the
+// middle of the heap and put back. Every periodic release re-arms the
+// deadline one relative deadline after it, on the period grid.
+//
+// The same synthetic set (T = 5, 7, 9; C = 2; U ~ 0.91) is then run
+// under EDF and, built as test_edf_fp, under rate-monotonic fixed
+// priorities: EDF meets every deadline, FP misses some of the T = 9
+// task's.
+
+
+#include "host/common.h"
+
+#define NTASKS          3
+#define SIM_TICKS       (4U * 315U)     // Four hyperperiods
+
+static const uint32_t g_period[NTASKS] = { 5, 7, 9 };
+static const uint32_t g_wcet[NTASKS] = { 2, 2, 2 };
+
+#if CONFIG_EDF
+static void test_heap_order(void)
+{
+    static const uint32_t deadline[] = { 9, 3, 7, 1, 8, 2, 6, 4, 5 };
+    const uint32_t n = sizeof(deadline) / sizeof(deadline[0]);
+    task_tcb_t *t[sizeof(deadline) / sizeof(deadline[0])];
+    task_tcb_t *next;
+    uint32_t i, expect;
+
+    for (i = 0; i < n; i++) {
+        t[i] = mk(10 + (int)i, 3);
+        CHECK(task_set_deadline(t[i], 0, deadline[i]) == KERNEL_OK);
+        CHECK(t[i]->priority == CONFIG_EDF_PRIORITY);
+    }
+
+    // Out of the middle and back in again
+    CHECK(task_suspend(t[8]) == KERNEL_OK);
+    CHECK(task_resume(t[8]) == KERNEL_OK);
+
+    for (expect = 1; expect <= n; expect++) {
+        next = pendsv();
+        CHECK(next != NULL && next->deadline == expect);
+        CHECK(task_suspend(next) == KERNEL_OK);
+    }
+    current_task = NULL;
+    for (i = 0; i < n; i++) {
+        CHECK(task_delete(t[i]) == KERNEL_OK);
+    }
+}
+#endif
+
+// Runs the set for SIM_TICKS; returns the total deadline-miss count
+static uint32_t simulate(void)
+{
+    task_tcb_t *t[NTASKS];
+    uint32_t work[NTASKS];
+    uint32_t tick, misses = 0;
+    int i, done;
+
+    for (i = 0; i < NTASKS; i++) {
+        // Rate-monotonic priorities when EDF is off
+        t[i] = mk(i, (uint8_t)(1 + i));
+        work[i] = g_wcet[i];
+        CHECK(task_set_deadline(t[i], g_period[i], g_period[i]) == KERNEL_OK);
+    }
+    (void)pendsv();
+
+    for (tick = 0; tick < SIM_TICKS; tick++) {
+        done = -1;
+        for (i = 0; i < NTASKS; i++) {
+            if (current_task == t[i] && --work[i] == 0U) {
+                work[i] = g_wcet[i];
+                done = i;
+            }
+        }
+        scheduler_tick();
+        if (done >= 0) {
+            (void)scheduler_wait_next_period();
+        }
+        (void)pendsv();
+
+        for (i = 0; i < NTASKS; i++) {
+            CHECK(t[i]->release_tick % g_period[i] == 0U);
+            CHECK(t[i]->deadline == t[i]->release_tick + g_period[i]);
+        }
+    }
+
+    for (i = 0; i < NTASKS; i++) {
+        misses += t[i]->deadline_misses;
+    }
+    return misses;
+}
+
+int main(void)
+{
+    uint32_t misses;
+
+    CHECK(kernel_init() == KERNEL_OK);
+#if CONFIG_EDF
+    test_heap_order();
+#endif
+
+    misses = simulate();
+#if CONFIG_EDF
+    CHECK(misses == 0U);
+    printf("test_edf: ok (EDF: %u deadline misses)\n", (unsigned)misses);
+#else
+    CHECK(misses > 0U);
+    printf("test_edf_fp: ok (FP: %u deadline misses)\n", (unsigned)misses);
+#endif
+    return 0;
+}
@@ -0,0 +1,152 @@
+// HelixRT - High-resolution timers
+//
+// GPT2 setup, deadline order and ties, stop, counter wrap, a passed
+// deadline pending the line, re-arming from a callback, and
+// hrtimer_sleep_us(). GPT2 and the NVIC are plain memory here: the
+// test moves CNT by hand and calls the interrupt handler itself.
+
+
+#include "host/uctx.h"
+
+#define GPT2_PENDING()  (NVIC_ISPR(3) & (1UL << 5))
+
+void GPT2_IRQHandler(void);
+
+static hrtimer_t g_a, g_b, g_c, g_d, g_rearm, g_unarmed;
+static int g_order[32];
+static int g_n = 0;
+static int g_rearms = 0;
+
+static volatile int g_phase = 0;
+static int g_sleep_result = 1;
+static uint32_t g_t0, g_woke;
+
+static void cb(void *arg)
+{
+    g_order[g_n++] = (int)(intptr_t)arg;
+}
+
+static void cb_rearm(void *arg)
+{
+    (void)arg;
+    g_order[g_n++] = 9;
+    if (++g_rearms < 3) {
+        (void)hrtimer_start(&g_rearm, 50);
+    }
+}
+
+// Take the GPT2 interrupt, then any PendSV it pended
+static void fire(void)
+{
+    host_isr = 1;
+    GPT2_IRQHandler();
+    host_isr = 0;
+    if (host_switch_hook != NULL) {
+        host_switch_hook();
+    }
+}
+
+static void sleeper(void *arg)
+{
+    (void)arg;
+
+    // A timer that is not armed (or already fired) refuses the block
+    CHECK(scheduler_block_task(BLOCK_HRTIMER, &g_unarmed, TIMEOUT_FOREVER) == KERNEL_OK);
+
+    g_t0 = hrtimer_now_us();
+    g_phase = 1;
+    g_sleep_result = hrtimer_sleep_us(500);
+    g_woke = hrtimer_now_us();
+    g_phase = 2;
+
+    // Deleted while sleeping
+    (void)hrtimer_sleep_us(1000);
+    g_phase = 3;
+}
+
+int main(void)
+{
+    task_tcb_t *s;
+    int k;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(GPT2->PR == ((11UL << 12) | 1UL));
+    CHECK((GPT2->CR & (GPT_CR_EN | GPT_CR_FRR | GPT_CR_EN_24M)) ==
+          (GPT_CR_EN | GPT_CR_FRR | GPT_CR_EN_24M));
+    CHECK(((GPT2->CR >> 6) & 7UL) == 5UL);
+    CHECK(NVIC_ISER(3) & (1UL << 5));
+    CHECK((CCM_CCGR0 & (3UL << 24)) && (CCM_CCGR0 & (3UL << 26)));
+
+    // Order, ties in arming order, stop
+    GPT2->CNT = 1000;
+    CHECK(hrtimer_create(&g_a, cb, (void *)1) == KERNEL_OK);
+    CHECK(hrtimer_create(&g_b, cb, (void *)2) == KERNEL_OK);
+    CHECK(hrtimer_create(&g_c, cb, (void *)3) == KERNEL_OK);
+    CHECK(hrtimer_create(&g_d, cb, (void *)4) == KERNEL_OK);
+    CHECK(hrtimer_start(&g_a, 300) == KERNEL_OK && GPT2->OCR1 == 1300U);
+    CHECK(hrtimer_start(&g_b, 100) == KERNEL_OK);
+    CHECK(hrtimer_start(&g_c, 200) == KERNEL_OK);
+    CHECK(hrtimer_start(&g_d, 100) == KERNEL_OK);
+    CHECK(GPT2->OCR1 == 1100U && (GPT2->IR & GPT_IR_OF1IE));
+    CHECK(hrtimer_stop(&g_c) == KERNEL_OK && !hrtimer_is_active(&g_c));
+    GPT2->CNT = 1099;
+    fire();
+    CHECK(g_n == 0);
+    GPT2->CNT = 1150;
+    fire();
+    CHECK(g_n == 2 && g_order[0] == 2 && g_order[1] == 4 && GPT2->OCR1 == 1300U);
+    CHECK(hrtimer_stop(&g_a) == KERNEL_OK && !(GPT2->IR & GPT_IR_OF1IE));
+
+    // Counter wrap
+    g_n = 0;
+    GPT2->CNT = 0xFFFFFF00UL;
+    CHECK(hrtimer_start(&g_a, 0x200) == KERNEL_OK);
+    CHECK(hrtimer_start(&g_b, 0x10) == KERNEL_OK);
+    CHECK(GPT2->OCR1 == 0xFFFFFF10UL);
+    GPT2->CNT = 0xFFFFFF20UL;
+    fire();
+    CHECK(g_n == 1 && g_order[0] == 2 && GPT2->OCR1 == 0x100U);
+    GPT2->CNT = 0x100;
+    fire();
+    CHECK(g_n == 2 && g_order[1] == 1 && !(GPT2->IR & GPT_IR_OF1IE));
+
+    // A deadline already passed pends the line
+    NVIC_ISPR(3) = 0;
+    CHECK(hrtimer_start(&g_a, 0) == KERNEL_OK && GPT2_PENDING());
+    g_n = 0;
+    fire();
+    CHECK(g_n == 1 && g_order[0] == 1);
+    CHECK(hrtimer_start(&g_a, 0x80000000UL) == KERNEL_ERR_PARAM);
+
+    // Re-arm from the callback
+    g_n = 0;
+    CHECK(hrtimer_create(&g_rearm, cb_rearm, NULL) == KERNEL_OK);
+    CHECK(hrtimer_start(&g_rearm, 50) == KERNEL_OK);
+    for (k = 0; k < 3; k++) {
+        GPT2->CNT += 50;
+        fire();
+    }
+    CHECK(g_n == 3 && !hrtimer_is_active(&g_rearm));
+
+    // Sleep wakes after exactly 500 counts; delete dequeues the stack timer
+    CHECK(hrtimer_create(&g_unarmed, cb, NULL) == KERNEL_OK);
+    s = &tcbs[0];
+    CHECK(task_create(s, "sleeper", sleeper, NULL, 3,
+                      stacks[0], sizeof(stacks[0])) == KERNEL_OK);
+    host_run(1);
+    CHECK(g_phase == 1 && s->state == TASK_STATE_BLOCKED);
+    CHECK(s->block_reason == BLOCK_HRTIMER && GPT2->OCR1 == g_t0 + 500U);
+    GPT2->CNT += 499;
+    fire();
+    CHECK(s->state == TASK_STATE_BLOCKED);
+    GPT2->CNT += 1;
+    fire();
+    host_run(1);
+    CHECK(g_phase == 2 && g_sleep_result == KERNEL_OK && g_woke - g_t0 == 500U);
+    CHECK(s->state == TASK_STATE_BLOCKED && (GPT2->IR & GPT_IR_OF1IE));
+    CHECK(task_delete(s) == KERNEL_OK);
+    CHECK(!(GPT2->IR & GPT_IR_OF1IE));
+
+    printf("test_hrtimer: ok\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+// HelixRT - Threaded interrupts
+//
+// A line routed to a task above the running one preempts it as soon
+// as the vector returns; a line below it waits until the task blocks.
+// Each line is masked until its thread has run, a top half can consume
+// the event, and an unrouted line is disabled and counted. IPSR is
+// read from host_ipsr.
+
+
+#include "host/uctx.h"
+
+#define IRQ_HIGH        20U
+#define IRQ_LOW         21U
+#define IRQ_UNROUTED    30U
+
+// The vector every external line lands on (kernel/irq.c)
+void Default_Handler(void);
+
+static irq_thread_t g_high, g_low;
+static uint32_t g_high_stack[512], g_low_stack[512];
+static int g_order[16];
+static int g_n = 0;
+
+static void thread(uint32_t irq, void *arg)
+{
+    (void)irq;
+    g_order[g_n++] = (int)(intptr_t)arg;
+}
+
+static bool top_consume(uint32_t irq, void *arg)
+{
+    (void)irq;
+    (void)arg;
+    return false;
+}
+
+// Take external interrupt @irq, then any PendSV it pended
+static void fire(uint32_t irq)
+{
+    host_isr = 1;
+    host_ipsr = irq + 16U;
+    Default_Handler();
+    host_isr = 0;
+    if (host_switch_hook != NULL) {
+        host_switch_hook();
+    }
+}
+
+static void app(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        g_order[g_n++] = 100;
+        fire(IRQ_HIGH);
+        g_order[g_n++] = 101;
+        fire(IRQ_LOW);
+        g_order[g_n++] = 102;
+        task_delay(5);
+    }
+}
+
+int main(void)
+{
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(task_create(&tcbs[0], "app", app, NULL, 5,
+                      stacks[0], sizeof(stacks[0])) == KERNEL_OK);
+    CHECK(irq_request_threaded(&g_high, IRQ_HIGH, NULL, thread, (void *)1, 2,
+                               g_high_stack, sizeof(g_high_stack)) == KERNEL_OK);
+    CHECK(NVIC_ISER(0) & (1UL << IRQ_HIGH));
+    CHECK(irq_request_threaded(&g_low, IRQ_LOW, NULL, thread, (void *)2, 8,
+                               g_low_stack, sizeof(g_low_stack)) == KERNEL_OK);
+    CHECK(irq_request_threaded(&g_low, IRQ_LOW, NULL, thread, (void *)2, 8,
+                               g_low_stack, sizeof(g_low_stack)) == KERNEL_ERR_STATE);
+
+    host_run(3);
+    CHECK(g_n == 5);
+    CHECK(g_order[0] == 100 && g_order[1] == 1 && g_order[2] == 101);
+    CHECK(g_order[3] == 102 && g_order[4] == 2);
+    CHECK(NVIC_ISER(0) & (1UL << IRQ_LOW));
+    CHECK(g_high.count == 1U && g_low.count == 1U);
+
+    // A top half that consumes the event runs no thread
+    g_low.top = top_consume;
+    fire(IRQ_LOW);
+    CHECK(g_low.count == 1U);
+
+    NVIC_ICER(0) = 0;
+    fire(IRQ_UNROUTED);
+    CHECK(irq_get_spurious() == 1U && (NVIC_ICER(0) & (1UL << IRQ_UNROUTED)));
+
+    printf("test_irq_thread: ok\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+// HelixRT - Direct task notifications
+//
+// Notification actions and masks, a pending value consumed without
+// blocking, a blocked waiter woken straight from an ISR, and the
+// timeout. From an ISR, the wake enters as many critical sections as
+// sem_give_isr() waking the same task, without a semaphore object.
+
+
+#include "host/common.h"
+
+// Run @tcb as the current task
+static void run(task_tcb_t *tcb)
+{
+    current_task = tcb;
+    tcb->state = TASK_STATE_RUNNING;
+}
+
+int main(void)
+{
+    semaphore_t sem;
+    task_tcb_t *a, *b;
+    uint32_t v = 0, c0, notify_crit, sem_crit;
+    int i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&sem, 0, 0) == KERNEL_OK);
+    a = mk(0, 3);
+    b = mk(1, 5);
+
+    // Pending before the wait: no block
+    run(b);
+    CHECK(task_notify(a, 0x5, NOTIFY_SET_BITS) == KERNEL_OK);
+    CHECK(task_notify(a, 0x2, NOTIFY_SET_BITS) == KERNEL_OK);
+    CHECK(task_notify(a, 9, NOTIFY_NO_OVERWRITE) == KERNEL_ERR_OVERFLOW);
+    run(a);
+    CHECK(task_notify_wait(0, NOTIFY_CLEAR_ALL, &v, TIMEOUT_FOREVER) == KERNEL_OK);
+    CHECK(v == 7U && a->notify_value == 0U && !a->notify_pending);
+    CHECK(task_notify_wait(0, 0, &v, TIMEOUT_NONE) == KERNEL_ERR_TIMEOUT);
+
+    // Blocked waiter woken from an ISR (the host returns at the switch point)
+    (void)task_notify_wait(0, 0, &v, TIMEOUT_FOREVER);
+    CHECK(a->state == TASK_STATE_BLOCKED && a->block_reason == BLOCK_NOTIFY);
+    CHECK(pendsv() == b);
+    host_isr = 1;
+    c0 = host_crit;
+    CHECK(task_notify_isr(a, 0, NOTIFY_INCREMENT) == KERNEL_OK);
+    notify_crit = host_crit - c0;
+    host_isr = 0;
+    CHECK(a->state == TASK_STATE_READY);
+    CHECK(pendsv() == a);
+    CHECK(a->notify_pending && a->notify_value == 1U);
+
+    // The same wake through a semaphore
+    a->notify_pending = 0;
+    run(a);
+    (void)scheduler_block_on(BLOCK_SEMAPHORE, &sem, &sem.wait_list_head,
+                             &sem.wait_list_tail, TIMEOUT_FOREVER);
+    CHECK(pendsv() == b);
+    host_isr = 1;
+    c0 = host_crit;
+    CHECK(sem_give_isr(&sem) == KERNEL_OK);
+    sem_crit = host_crit - c0;
+    host_isr = 0;
+    CHECK(a->state == TASK_STATE_READY);
+    CHECK(notify_crit == sem_crit);
+
+    // Timeout
+    CHECK(pendsv() == a);
+    (void)task_notify_wait(0, 0, &v, 3);
+    CHECK(pendsv() == b);
+    for (i = 0; i < 3; i++) {
+        scheduler_tick();
+    }
+    CHECK(a->state == TASK_STATE_READY && a->block_result == KERNEL_ERR_TIMEOUT);
+
+    printf("test_notify: ok\n");
+    return 0;
+}
@@ -0,0 +1,72 @@
+// HelixRT - Time partition windows
+//
+// A six-tick major frame gives partition 1 three ticks, partition 2
+// two and the system partition one. Busy workers in partitions 1 and
+// 2 each get exactly their share and only run inside their own
+// windows; a system-partition task still runs in every window. The
+// switch trace keeps the latest switches, oldest first, each one
+// leaving the partition the previous one entered.
+
+
+#include "host/uctx.h"
+
+#define FRAMES          100U
+
+static uint32_t g_runs[CONFIG_PARTITION_COUNT];
+static uint32_t g_sys_runs = 0;
+
+PARTITION_FRAME_DEFINE(g_frame, { 1, 3 }, { 2, 2 }, { 0, 1 });
+
+static void worker(void *arg)
+{
+    uint8_t partition = (uint8_t)(uintptr_t)arg;
+
+    for (;;) {
+        CHECK(partition_get_active() == partition);
+        g_runs[partition]++;
+        host_work(1);
+    }
+}
+
+static void sys(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        g_sys_runs++;
+        task_delay(7);
+    }
+}
+
+int main(void)
+{
+    partition_trace_t trace[CONFIG_PARTITION_TRACE_DEPTH];
+    uint32_t n, i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    // The low-priority worker must not lose its window to the other
+    CHECK(task_create(&tcbs[0], "p1", worker, (void *)1, 20,
+                      stacks[0], sizeof(stacks[0])) == KERNEL_OK);
+    CHECK(task_create(&tcbs[1], "p2", worker, (void *)2, 5,
+                      stacks[1], sizeof(stacks[1])) == KERNEL_OK);
+    CHECK(task_create(&tcbs[2], "sys", sys, NULL, 2,
+                      stacks[2], sizeof(stacks[2])) == KERNEL_OK);
+    CHECK(task_set_partition(&tcbs[0], 1) == KERNEL_OK);
+    CHECK(task_set_partition(&tcbs[1], 2) == KERNEL_OK);
+    CHECK(task_set_partition(&tcbs[1], CONFIG_PARTITION_COUNT) == KERNEL_ERR_PARAM);
+    CHECK(partition_set_table(g_frame, PARTITION_FRAME_COUNT(g_frame)) == KERNEL_OK);
+
+    host_run(FRAMES * 6U);
+    CHECK(g_runs[1] == FRAMES * 3U && g_runs[2] == FRAMES * 2U);
+    CHECK(g_sys_runs >= (FRAMES * 6U) / 7U - 2U);
+
+    n = partition_trace_read(trace, CONFIG_PARTITION_TRACE_DEPTH);
+    CHECK(n == CONFIG_PARTITION_TRACE_DEPTH);
+    for (i = 1; i < n; i++) {
+        CHECK(trace[i].tick > trace[i - 1U].tick);
+        CHECK(trace[i].from == trace[i - 1U].to);
+    }
+    CHECK(trace[n - 1U].tick + 6U > kernel_get_tick());
+
+    printf("test_partitions: ok\n");
+    return 0;
+}
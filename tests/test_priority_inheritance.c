@@ -0,0 +1,151 @@
+// HelixRT - Transitive priority inheritance
+//
+// D (5) waits on a chain C -> B -> A of nested mutexes while X (7) is
+// ready to burn 50 ticks. Inheritance lifts the whole chain above X,
+// so D waits only for the chain's own work. A waiter that times out
+// or is suspended gives the boost back.
+
+
+#include "host/uctx.h"
+
+static mutex_t g_m1, g_m2, g_m3, g_solo;
+static task_tcb_t *A, *B, *C, *D, *X;
+static uint32_t g_d_blocked;
+static uint8_t g_a_boosted;
+
+static void task_a(void *arg)
+{
+    (void)arg;
+    CHECK(mutex_lock(&g_m1, TIMEOUT_FOREVER) == KERNEL_OK);
+    host_work(10);
+    g_a_boosted = A->priority;
+    CHECK(mutex_unlock(&g_m1) == KERNEL_OK);
+    CHECK(A->priority == 20);
+    (void)task_suspend(NULL);
+}
+
+static void task_b(void *arg)
+{
+    (void)arg;
+    task_delay(1);
+    CHECK(mutex_lock(&g_m2, TIMEOUT_FOREVER) == KERNEL_OK);
+    CHECK(mutex_lock(&g_m1, TIMEOUT_FOREVER) == KERNEL_OK);
+    host_work(1);
+    CHECK(mutex_unlock(&g_m1) == KERNEL_OK);
+    CHECK(mutex_unlock(&g_m2) == KERNEL_OK);
+    CHECK(B->priority == 15);
+    (void)task_suspend(NULL);
+}
+
+static void task_c(void *arg)
+{
+    (void)arg;
+    task_delay(2);
+    CHECK(mutex_lock(&g_m3, TIMEOUT_FOREVER) == KERNEL_OK);
+    CHECK(mutex_lock(&g_m2, TIMEOUT_FOREVER) == KERNEL_OK);
+    host_work(1);
+    CHECK(mutex_unlock(&g_m2) == KERNEL_OK);
+    CHECK(mutex_unlock(&g_m3) == KERNEL_OK);
+    (void)task_suspend(NULL);
+}
+
+static void task_d(void *arg)
+{
+    uint32_t t0;
+
+    (void)arg;
+    task_delay(3);
+
+    // A waiter that times out un-boosts the chain
+    CHECK(mutex_lock(&g_m3, 1) == KERNEL_ERR_TIMEOUT);
+    CHECK(A->priority == 10 && B->priority == 10 && C->priority == 10);
+
+    t0 = host_now;
+    CHECK(mutex_lock(&g_m3, TIMEOUT_FOREVER) == KERNEL_OK);
+    g_d_blocked = host_now - t0;
+    CHECK(mutex_unlock(&g_m3) == KERNEL_OK);
+    (void)task_suspend(NULL);
+}
+
+static void task_x(void *arg)
+{
+    (void)arg;
+    task_delay(6);
+    host_work(50);
+    (void)task_suspend(NULL);
+}
+
+// Second scenario: a suspended waiter leaves the queue and the boost
+static task_tcb_t *L, *H;
+static int g_h_result = 1;
+static int g_suspended = 0;
+
+static void task_l(void *arg)
+{
+    (void)arg;
+    CHECK(mutex_lock(&g_solo, TIMEOUT_FOREVER) == KERNEL_OK);
+    host_work(20);
+    CHECK(mutex_unlock(&g_solo) == KERNEL_OK);
+    (void)task_suspend(NULL);
+}
+
+static void task_h(void *arg)
+{
+    (void)arg;
+    task_delay(1);
+    g_h_result = mutex_lock(&g_solo, TIMEOUT_FOREVER);
+    (void)task_suspend(NULL);
+}
+
+static void task_s(void *arg)
+{
+    (void)arg;
+    task_delay(3);
+    CHECK(H->state == TASK_STATE_BLOCKED && H->block_reason == BLOCK_MUTEX);
+    CHECK(L->priority == 5);
+    CHECK(task_suspend(H) == KERNEL_OK);
+    CHECK(L->priority == 20 && g_solo.wait_list_head == NULL);
+    g_suspended = 1;
+    (void)task_suspend(NULL);
+}
+
+static void create(task_tcb_t *tcb, int i, const char *name,
+                   void (*entry)(void *), uint8_t prio)
+{
+    CHECK(task_create(tcb, name, entry, NULL, prio,
+                      stacks[i], sizeof(stacks[i])) == KERNEL_OK);
+}
+
+int main(void)
+{
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(mutex_init(&g_m1, 0) == KERNEL_OK);
+    CHECK(mutex_init(&g_m2, 0) == KERNEL_OK);
+    CHECK(mutex_init(&g_m3, 0) == KERNEL_OK);
+    CHECK(mutex_init(&g_solo, 0) == KERNEL_OK);
+
+    A = &tcbs[0];
+    B = &tcbs[1];
+    C = &tcbs[2];
+    D = &tcbs[3];
+    X = &tcbs[4];
+    create(A, 0, "A", task_a, 20);
+    create(B, 1, "B", task_b, 15);
+    create(C, 2, "C", task_c, 10);
+    create(D, 3, "D", task_d, 5);
+    create(X, 4, "X", task_x, 7);
+    host_run(100);
+    CHECK(g_a_boosted == 5);
+    CHECK(g_d_blocked < 15U);
+
+    L = &tcbs[5];
+    H = &tcbs[6];
+    create(L, 5, "L", task_l, 20);
+    create(H, 6, "H", task_h, 5);
+    create(&tcbs[7], 7, "S", task_s, 3);
+    host_run(40);
+    CHECK(g_suspended && g_h_result == 1 && g_solo.owner == NULL);
+
+    printf("test_priority_inheritance: ok (D blocked %u ticks)\n", g_d_blocked);
+    return 0;
+}
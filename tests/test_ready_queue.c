@@ -0,0 +1,64 @@
+// HelixRT - Ready queue rotation and removal
+//
+// Yield rotates equal-priority tasks in creation order; unlinking the
+// head, a middle entry or the tail keeps the list and its tail pointer
+// consistent, and an emptied priority falls through to the idle task.
+
+
+#include "host/common.h"
+
+#define NTASKS          16
+
+static int ready_count(void)
+{
+    task_tcb_t *it = scheduler_get_next();
+    int n = 0;
+
+    while (it != NULL && it->priority == 4U) {
+        n++;
+        it = it->next;
+    }
+    return n;
+}
+
+int main(void)
+{
+    task_tcb_t *t[NTASKS];
+    int i, r;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    for (i = 0; i < NTASKS; i++) {
+        t[i] = mk(i, 4);
+    }
+
+    CHECK(pendsv() == t[0]);
+    for (r = 0; r < 40; r++) {
+        scheduler_yield();
+        CHECK(pendsv() == t[(r + 1) % NTASKS]);
+    }
+
+    // Middle and tail removal, then re-append through the tail pointer
+    CHECK(task_suspend(t[5]) == KERNEL_OK);
+    CHECK(task_suspend(t[8]) == KERNEL_OK);
+    CHECK(t[5]->state == TASK_STATE_SUSPENDED);
+    CHECK(task_resume(t[5]) == KERNEL_OK);
+    CHECK(ready_count() == NTASKS - 1);
+
+    // Yielding still visits every ready task exactly once per round
+    for (r = 0; r < NTASKS - 1; r++) {
+        scheduler_yield();
+        (void)pendsv();
+        CHECK(current_task != t[8]);
+    }
+
+    for (i = 0; i < NTASKS; i++) {
+        if (i != 8) {
+            CHECK(task_suspend(t[i]) == KERNEL_OK);
+        }
+    }
+    current_task = NULL;
+    CHECK(scheduler_get_next()->priority == CONFIG_MAX_PRIORITY - 1);
+
+    printf("test_ready_queue: ok\n");
+    return 0;
+}
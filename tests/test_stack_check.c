@@ -0,0 +1,102 @@
+// HelixRT - Stack guard and high-water scan
+//
+// A new task's stack has the guard word at its base and the fill
+// pattern above it. PendSV retires an outgoing task whose guard word is
+// gone or whose saved sp reached the base (modelled here in C, as
+// context.s does it), calling the overflow hook and picking another
+// task. The idle scan records each task's deepest use in bounded steps;
+// marks only grow, and a task retired while the scan is inside its
+// stack is skipped from then on.
+
+
+#include "host/common.h"
+
+#define STACK_WORDS     (sizeof(stacks[0]) / sizeof(uint32_t))
+#define SCAN_PASS       40
+
+void stack_scan_step(void);
+void kernel_stack_overflow(task_tcb_t *tcb);
+extern task_tcb_t *g_scan_task;
+
+static task_tcb_t *g_overflowed = NULL;
+
+void kernel_stack_overflow_hook(task_tcb_t *tcb)
+{
+    g_overflowed = tcb;
+}
+
+// PendSV's check on the outgoing task, then the next selection
+static task_tcb_t *switch_out(task_tcb_t *prev)
+{
+    current_task = prev;
+    prev->state = TASK_STATE_RUNNING;
+    if (prev->sp <= prev->stack_base || prev->stack_base[0] != CONFIG_STACK_GUARD_WORD) {
+        kernel_stack_overflow(prev);
+    }
+    return pendsv();
+}
+
+static void scan(int steps)
+{
+    while (steps-- > 0) {
+        stack_scan_step();
+    }
+}
+
+int main(void)
+{
+    task_tcb_t *a, *b, *c;
+    uint32_t frame;
+    int i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    a = mk(0, 5);
+    b = mk(1, 6);
+    c = mk(2, 7);
+    CHECK(a->stack_base[0] == CONFIG_STACK_GUARD_WORD);
+    CHECK(a->stack_base[1] == TASK_STACK_FILL);
+
+    // The initial frame is the only use so far
+    scan(SCAN_PASS);
+    frame = a->max_stack_used;
+    CHECK(frame > 0U && frame <= 32U * sizeof(uint32_t));
+    CHECK(b->max_stack_used == frame);
+
+    // A deeper word raises the mark; restoring the fill does not lower it
+    a->stack_base[200] = 0x1234U;
+    scan(SCAN_PASS);
+    CHECK(a->max_stack_used == (STACK_WORDS - 200U) * sizeof(uint32_t));
+    a->stack_base[200] = TASK_STACK_FILL;
+    scan(SCAN_PASS);
+    CHECK(a->max_stack_used == (STACK_WORDS - 200U) * sizeof(uint32_t));
+    b->stack_base[1] = 0U;
+    scan(SCAN_PASS);
+    CHECK(b->max_stack_used == (STACK_WORDS - 1U) * sizeof(uint32_t));
+
+    // Guard word overwritten: retired at the switch, another task runs
+    a->stack_base[0] = 0U;
+    CHECK(switch_out(a) == b);
+    CHECK(g_overflowed == a && a->state == TASK_STATE_DELETED);
+
+    // Saved sp at the base, with the scan part-way through the stack
+    for (i = 0; g_scan_task != c; i++) {
+        CHECK(i < SCAN_PASS);
+        stack_scan_step();
+    }
+    stack_scan_step();
+    CHECK(g_scan_task == c);
+    c->sp = c->stack_base;
+    g_overflowed = NULL;
+    (void)switch_out(c);
+    CHECK(g_overflowed == c && c->state == TASK_STATE_DELETED);
+    CHECK(g_scan_task != c);
+    scan(SCAN_PASS);
+
+    // Deleted from outside: the scan moves on as well
+    current_task = NULL;
+    CHECK(task_delete(b) == KERNEL_OK);
+    scan(SCAN_PASS);
+
+    printf("test_stack_check: ok\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+// HelixRT - Suspending a blocked task
+//
+// A task suspended while blocked leaves the wait list, and the call it
+// was blocked in fails with KERNEL_ERR_STATE once it is resumed: a
+// semaphore take must not succeed without a unit, and a periodic wait
+// still releases the next job.
+
+
+#include "host/uctx.h"
+
+static semaphore_t g_sem;
+static task_tcb_t *g_waiter, *g_periodic, *g_control;
+static int g_take_result = 1;
+static int g_period_result = 1;
+static uint32_t g_period_release;
+static uint32_t g_jobs = 0;
+static int g_done = 0;
+
+static void waiter(void *arg)
+{
+    (void)arg;
+    g_take_result = sem_take(&g_sem, TIMEOUT_FOREVER);
+    (void)task_suspend(NULL);
+}
+
+static void job(void *arg)
+{
+    (void)arg;
+    g_jobs++;
+}
+
+// Job loop run directly by the host, in place of the kernel's own
+static void periodic(void *arg)
+{
+    int res;
+
+    for (;;) {
+        job(arg);
+        res = task_wait_next_period();
+        if (res == KERNEL_ERR_STATE) {
+            g_period_result = res;
+            g_period_release = g_periodic->release_tick;
+        }
+    }
+}
+
+static void control(void *arg)
+{
+    (void)arg;
+    task_delay(2);
+
+    CHECK(g_waiter->state == TASK_STATE_BLOCKED);
+    CHECK(g_periodic->state == TASK_STATE_BLOCKED);
+    CHECK(task_suspend(g_waiter) == KERNEL_OK);
+    CHECK(task_suspend(g_periodic) == KERNEL_OK);
+    CHECK(g_sem.wait_list_head == NULL);
+
+    CHECK(task_resume(g_waiter) == KERNEL_OK);
+    CHECK(task_resume(g_waiter) == KERNEL_ERR_PARAM);
+    CHECK(task_resume(g_periodic) == KERNEL_OK);
+    task_delay(1);
+
+    CHECK(g_take_result == KERNEL_ERR_STATE && g_sem.count == 0U);
+    CHECK(g_period_result == KERNEL_ERR_STATE && g_period_release == 10U);
+    g_done = 1;
+    (void)task_suspend(NULL);
+}
+
+int main(void)
+{
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&g_sem, 0, 1) == KERNEL_OK);
+
+    g_waiter = &tcbs[0];
+    g_periodic = &tcbs[1];
+    g_control = &tcbs[2];
+    CHECK(task_create(g_waiter, "waiter", waiter, NULL, 6,
+                      stacks[0], sizeof(stacks[0])) == KERNEL_OK);
+    CHECK(task_create_periodic(g_periodic, "periodic", job, NULL, 5,
+                               stacks[1], sizeof(stacks[1]), 10, 0, 1) == KERNEL_OK);
+    g_periodic->entry = periodic;
+    CHECK(task_create(g_control, "control", control, NULL, 3,
+                      stacks[2], sizeof(stacks[2])) == KERNEL_OK);
+
+    host_run(20);
+    CHECK(g_done && g_jobs >= 2U);
+
+    printf("test_suspend_blocked: ok\n");
+    return 0;
+}
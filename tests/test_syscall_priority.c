@@ -0,0 +1,44 @@
+// HelixRT - Kernel interrupt priority threshold
+//
+// With CONFIG_KERNEL_MAX_SYSCALL_PRIORITY set, kernel_init() leaves
+// PendSV and SysTick at the bottom and drops SVCall to the threshold,
+// and a vector that calls the kernel (a threaded IRQ) is never left
+// more urgent than the threshold. The BASEPRI critical sections are
+// inline assembly and are replaced by the host shim.
+
+
+#include "host/common.h"
+
+#define IRQ_URGENT      100U
+#define IRQ_RELAXED     101U
+
+static uint32_t g_irq_stacks[2][256];
+static irq_thread_t g_urgent, g_relaxed;
+
+static void thread(uint32_t irq, void *arg)
+{
+    (void)irq;
+    (void)arg;
+}
+
+int main(void)
+{
+    CHECK(CONFIG_KERNEL_MAX_SYSCALL_PRIORITY == 5);
+    CHECK(kernel_init() == KERNEL_OK);
+
+    CHECK((SCB_SHPR2 >> 24) == (5U << 4));
+    CHECK(((SCB_SHPR3 >> 16) & 0xFFU) == 0xFFU);
+    CHECK((SCB_SHPR3 >> 24) == 0xFEU);
+
+    NVIC_IPR(IRQ_URGENT) = 2U << 4;
+    NVIC_IPR(IRQ_RELAXED) = 8U << 4;
+    CHECK(irq_request_threaded(&g_urgent, IRQ_URGENT, NULL, thread, NULL, 3,
+                               g_irq_stacks[0], sizeof(g_irq_stacks[0])) == KERNEL_OK);
+    CHECK(irq_request_threaded(&g_relaxed, IRQ_RELAXED, NULL, thread, NULL, 3,
+                               g_irq_stacks[1], sizeof(g_irq_stacks[1])) == KERNEL_OK);
+    CHECK(NVIC_IPR(IRQ_URGENT) == (5U << 4));
+    CHECK(NVIC_IPR(IRQ_RELAXED) == (8U << 4));
+
+    printf("test_syscall_priority: ok\n");
+    return 0;
+}
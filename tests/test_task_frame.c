@@ -0,0 +1,51 @@
+// HelixRT - Initial task frame
+//
+// A new task's stack holds the software frame PendSV restores over the
+// hardware frame the exception return pops. Its EXC_RETURN selects the
+// process stack and has bit 4 set, so the first switch to it neither
+// restores s16-s31 nor expects an extended FP frame; FP state is only
+// tracked once the task uses the FPU. PendSV itself is assembly and is
+// not run on the host, so this checks the frame layout only; the cost
+// of a switch with and without FP state has to be measured on target.
+
+
+#include "host/common.h"
+
+#define FRAME_WORDS     ((sizeof(sw_stack_frame_t) + sizeof(hw_stack_frame_t)) / 4U)
+
+static void entry(void *arg)
+{
+    (void)arg;
+}
+
+int main(void)
+{
+    static int arg;
+    task_tcb_t *t;
+    sw_stack_frame_t *sw;
+    hw_stack_frame_t *hw;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(task_create(&tcbs[0], "t", entry, &arg, 5,
+                      stacks[0], sizeof(stacks[0])) == KERNEL_OK);
+    t = &tcbs[0];
+
+    CHECK(FRAME_WORDS == 17U);
+    CHECK(t->sp == t->stack_top - FRAME_WORDS);
+    CHECK(((uintptr_t)t->stack_top & 7U) == 0U);
+
+    sw = (sw_stack_frame_t *)t->sp;
+    hw = (hw_stack_frame_t *)(sw + 1);
+    CHECK(sw->exc_return == EXC_RETURN_THREAD_PSP);
+    CHECK((sw->exc_return & (1UL << 4)) != 0U);
+    CHECK((EXC_RETURN_THREAD_PSP_FPU & (1UL << 4)) == 0U);
+    CHECK(sw->r4 == 0U && sw->r11 == 0U);
+
+    CHECK(hw->r0 == (uint32_t)(uintptr_t)&arg);
+    CHECK(hw->pc == (uint32_t)(uintptr_t)entry);
+    CHECK(hw->lr != 0U);
+    CHECK(hw->xpsr == 0x01000000UL);
+
+    printf("test_task_frame: ok\n");
+    return 0;
+}
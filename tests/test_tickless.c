@@ -0,0 +1,114 @@
+// HelixRT - Tickless idle
+//
+// The idle sleep length comes from the earliest timeout or timer, is
+// capped by the 24-bit SysTick reload, and the ticks that pass while
+// asleep are credited on wake, both after a full sleep and after an
+// early wake by another interrupt. SysTick is modelled in the WFI hook;
+// COUNTFLAG is read from host_countflag (see HOSTSED in the Makefile).
+
+
+#include "host/common.h"
+
+#define TICK_CYCLES     (CONFIG_CPU_CLOCK_HZ / CONFIG_TICK_RATE_HZ)
+#define MAX_IDLE        (SYSTICK_RVR_MAX / TICK_CYCLES)
+
+bool tickless_sleep(void);
+
+uint32_t host_countflag;
+
+// Modelled sleep: woken early after g_early cycles, or else run to the
+// programmed reload and g_overshoot cycles past it
+static uint32_t g_early;
+static uint32_t g_overshoot;
+static uint32_t g_programmed;
+static int g_fired;
+
+static void systick_wfi(void)
+{
+    g_programmed = SYSTICK_RVR + 1U;
+    if (g_early != 0U) {
+        host_countflag = 0;
+        SYSTICK_CVR = g_programmed - g_early;
+    } else {
+        host_countflag = 1;
+        SYSTICK_CVR = (g_overshoot == 0U) ? 0U : g_programmed - g_overshoot;
+    }
+}
+
+static void timer_cb(void *arg)
+{
+    (void)arg;
+    g_fired++;
+}
+
+// Sleep with @cvr cycles left in the current tick
+static bool sleep_from(uint32_t cvr, uint32_t early, uint32_t overshoot)
+{
+    SYSTICK_CVR = cvr;
+    g_early = early;
+    g_overshoot = overshoot;
+    return tickless_sleep();
+}
+
+int main(void)
+{
+    task_tcb_t *a, *b, *idle;
+    sw_timer_t tm;
+    uint32_t t0;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    host_wfi_hook = systick_wfi;
+    a = mk(0, 5);
+    b = mk(1, 6);
+    (void)host_block(a, BLOCK_DELAY, NULL, NULL, NULL, 10);
+    (void)host_block(b, BLOCK_DELAY, NULL, NULL, NULL, 25);
+    idle = pendsv();
+    CHECK(idle != NULL && idle->priority == CONFIG_MAX_PRIORITY - 1);
+
+    // Credit paths on their own
+    CHECK(scheduler_next_wake_ticks() == 10);
+    CHECK(timer_create(&tm, timer_cb, NULL) == KERNEL_OK);
+    CHECK(timer_start(&tm, 7, 0) == KERNEL_OK);
+    CHECK(timer_next_expiry() == 7);
+    scheduler_advance_ticks(6);
+    timer_advance(6);
+    CHECK(scheduler_get_tick_count() == 6);
+    CHECK(scheduler_next_wake_ticks() == 4 && timer_next_expiry() == 1);
+
+    // One tick away is below CONFIG_TICKLESS_MIN_TICKS
+    CHECK(!sleep_from(TICK_CYCLES / 2U, 0, 0));
+    host_tick();
+    CHECK(g_fired == 1);
+
+    // Full sleep to a's deadline, half a tick in: the last tick is
+    // left to SysTick_Handler and the counter resumes on the grid
+    CHECK(sleep_from(TICK_CYCLES / 2U, 0, 1000U));
+    CHECK(g_programmed == TICK_CYCLES / 2U + TICK_CYCLES * 2U);
+    CHECK(scheduler_get_tick_count() == 9 && a->state == TASK_STATE_BLOCKED);
+    CHECK(SYSTICK_RVR == TICK_CYCLES - 1U);
+    host_tick();
+    CHECK(scheduler_get_tick_count() == 10 && a->state == TASK_STATE_READY);
+
+    // Early wake 100k cycles into the fourth tick of b's 15-tick wait
+    CHECK(task_suspend(a) == KERNEL_OK);
+    CHECK(pendsv() == idle);
+    t0 = scheduler_get_tick_count();
+    CHECK(sleep_from(300000U, 300000U + 3U * TICK_CYCLES + 100000U, 0));
+    CHECK(scheduler_get_tick_count() == t0 + 4U);
+    CHECK(b->state == TASK_STATE_BLOCKED);
+    CHECK(scheduler_next_wake_ticks() == 11);
+
+    // A long wait is cut to what the 24-bit reload can hold
+    CHECK(task_resume(a) == KERNEL_OK);
+    (void)host_block(a, BLOCK_DELAY, NULL, NULL, NULL, 1000);
+    CHECK(task_suspend(b) == KERNEL_OK);
+    current_task = idle;
+    t0 = scheduler_get_tick_count();
+    CHECK(sleep_from(TICK_CYCLES, 0, 0));
+    CHECK(g_programmed == TICK_CYCLES * MAX_IDLE);
+    host_tick();
+    CHECK(scheduler_get_tick_count() == t0 + MAX_IDLE);
+
+    printf("test_tickless: ok\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+// HelixRT - 64-bit time base
+//
+// kernel_time_cycles() counts every CYCCNT cycle exactly across many
+// 2^32 wraps, and kernel_time_ns() stays within a couple of ns of the
+// exact conversion. The tick re-anchors the epoch; a reader that is
+// interrupted by one or two re-anchors between its two generation
+// reads retries, and what it returns never goes backwards.
+
+
+#include "host/common.h"
+
+#define CORE_HZ         600000000UL
+#define STEPS           3000000UL
+
+extern volatile uint32_t SystemCoreClock;
+
+static uint64_t g_total = 0;
+static int g_anchors = 0;
+static int g_reads = 0;
+
+// Cycles pass, then the tick re-anchors
+static void advance(uint32_t cycles, int anchor)
+{
+    DWT_CYCCNT += cycles;
+    g_total += cycles;
+    if (anchor) {
+        kernel_time_tick();
+    }
+}
+
+// Called by time_read() between copying the epoch and re-reading the
+// generation (HOSTSED): the tick preempts the reader there
+void host_time_read_hook(void)
+{
+    g_reads++;
+    while (g_anchors > 0) {
+        g_anchors--;
+        advance(CORE_HZ / 1000U, 1);
+    }
+}
+
+int main(void)
+{
+    uint64_t c, n, last_c = 0, last_n = 0;
+    double exact, err, max_err = 0.0;
+    uint32_t k;
+    int anchors;
+
+    SystemCoreClock = CORE_HZ;
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(kernel_time_cycles() == 0U && kernel_time_ns() == 0U);
+
+    // Uneven steps, re-anchored every fifth, through many CYCCNT wraps
+    for (k = 1; k <= STEPS; k++) {
+        advance(CORE_HZ / 1000U + (k & 7U), k % 5U == 0U);
+        if (k % 1000U == 0U) {
+            c = kernel_time_cycles();
+            n = kernel_time_ns();
+            CHECK(c == g_total && c >= last_c && n >= last_n);
+            exact = (double)c * 1e9 / (double)CORE_HZ;
+            err = (n > exact) ? (double)n - exact : exact - (double)n;
+            if (err > max_err) {
+                max_err = err;
+            }
+            last_c = c;
+            last_n = n;
+        }
+    }
+    CHECK(g_total > 100ULL * 0x100000000ULL);
+    // Under 2 ns plus 1 ppb of drift
+    CHECK(max_err < 2.0 + (double)g_total / (double)CORE_HZ);
+
+    // One and then two re-anchors inside a read: each read retries once
+    for (anchors = 1; anchors <= 2; anchors++) {
+        advance(12345U, 0);
+        g_reads = 0;
+        g_anchors = anchors;
+        c = kernel_time_cycles();
+        CHECK(g_reads == 2 && c == g_total && c > last_c);
+        g_anchors = anchors;
+        n = kernel_time_ns();
+        CHECK(n > last_n);
+        last_c = c;
+        last_n = n;
+    }
+
+    printf("test_time_base: ok (max error %.3f ns over %.0f s)\n",
+           max_err, (double)g_total / (double)CORE_HZ);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// HelixRT - Delta-sorted timeout list
+//
+// Delays and object timeouts expire on their exact tick, in any
+// arrival order; a waiter removed early leaves the others' timing
+// intact; tasks blocked forever are never touched by the tick.
+
+
+#include "host/common.h"
+
+#define MANY_FIRST      5
+#define MANY_LAST       25
+
+static uint32_t many_delay(int i)
+{
+    return (uint32_t)((i * 7) % 13 + 1);
+}
+
+int main(void)
+{
+    semaphore_t sem;
+    task_tcb_t *a, *b, *c, *d, *e;
+    uint32_t tick;
+    int i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&sem, 0, 0) == KERNEL_OK);
+    a = mk(0, 5);
+    b = mk(1, 3);
+    c = mk(2, 5);
+    d = mk(3, 7);
+    e = mk(4, 7);
+
+    (void)host_block(a, BLOCK_DELAY, NULL, NULL, NULL, 5);
+    (void)host_block(b, BLOCK_SEMAPHORE, &sem, &sem.wait_list_head, &sem.wait_list_tail, 3);
+    (void)host_block(c, BLOCK_DELAY, NULL, NULL, NULL, 5);
+    (void)host_block(d, BLOCK_SEMAPHORE, &sem, &sem.wait_list_head, &sem.wait_list_tail,
+                     TIMEOUT_FOREVER);
+    (void)host_block(e, BLOCK_DELAY, NULL, NULL, NULL, 0);
+
+    // A zero delay still waits one tick
+    scheduler_tick();
+    CHECK(e->state == TASK_STATE_READY && e->block_result == KERNEL_OK);
+
+    // The object wait times out on tick 3 and leaves the wait list
+    scheduler_tick();
+    CHECK(b->state == TASK_STATE_BLOCKED);
+    scheduler_tick();
+    CHECK(b->state == TASK_STATE_READY && b->block_result == KERNEL_ERR_TIMEOUT);
+    CHECK(sem.wait_list_head == d && d->wait_next == NULL);
+
+    // Removing c, queued behind a with the same expiry, keeps a on time
+    scheduler_tick();
+    CHECK(a->state == TASK_STATE_BLOCKED);
+    CHECK(task_delete(c) == KERNEL_OK);
+    scheduler_tick();
+    CHECK(a->state == TASK_STATE_READY && a->block_result == KERNEL_OK);
+
+    // Forever means forever
+    for (i = 0; i < 100; i++) {
+        scheduler_tick();
+    }
+    CHECK(d->state == TASK_STATE_BLOCKED);
+
+    // Twenty delays inserted out of order, several sharing a tick
+    for (i = MANY_FIRST; i < MANY_LAST; i++) {
+        (void)mk(i, 10);
+        (void)host_block(&tcbs[i], BLOCK_DELAY, NULL, NULL, NULL, many_delay(i));
+    }
+    for (tick = 1; tick <= 14U; tick++) {
+        scheduler_tick();
+        for (i = MANY_FIRST; i < MANY_LAST; i++) {
+            CHECK((tcbs[i].state == TASK_STATE_BLOCKED) == (many_delay(i) > tick));
+        }
+    }
+
+    printf("test_timeout_list: ok\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+// HelixRT - Timer callbacks in the timer task
+//
+// With CONFIG_TIMER_DAEMON the tick only moves expired timers onto a
+// FIFO and notifies the timer task, which runs the callbacks in task
+// context, in expiry order, where they may block. A stop withdraws an
+// expiry still on the FIFO and a restart supersedes it; a periodic
+// timer whose callback overruns is queued once, not once per expiry.
+
+
+#include "host/uctx.h"
+
+static sw_timer_t g_a, g_b, g_c, g_d, g_slow;
+static char g_order[8];
+static int g_ran = 0;
+static int g_slow_runs = 0;
+static uint32_t g_b_tick = 0;
+static const char *g_ctx = NULL;
+
+static void record(void *arg)
+{
+    CHECK(g_ran < (int)sizeof(g_order) - 1);
+    g_order[g_ran++] = *(const char *)arg;
+    g_ctx = (task_get_current() != NULL) ? task_get_current()->name : "isr";
+    CHECK(!host_isr);
+}
+
+static void record_b(void *arg)
+{
+    record(arg);
+    g_b_tick = kernel_get_tick();
+}
+
+// Blocks for longer than its period
+static void slow(void *arg)
+{
+    (void)arg;
+    g_slow_runs++;
+    task_delay(3);
+}
+
+int main(void)
+{
+    uint32_t start;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(timer_create(&g_a, record, "a") == KERNEL_OK);
+    CHECK(timer_create(&g_b, record_b, "b") == KERNEL_OK);
+    CHECK(timer_create(&g_c, record, "c") == KERNEL_OK);
+    CHECK(timer_create(&g_d, record, "d") == KERNEL_OK);
+    CHECK(timer_create(&g_slow, slow, NULL) == KERNEL_OK);
+
+    // The tick only queues; nothing runs until the timer task does.
+    // A wheel bucket is LIFO, so started c, b, a to queue a, b, c.
+    CHECK(timer_start(&g_c, 1, 0) == KERNEL_OK);
+    CHECK(timer_start(&g_b, 1, 0) == KERNEL_OK);
+    CHECK(timer_start(&g_a, 1, 0) == KERNEL_OK);
+    host_tick();
+    CHECK(g_ran == 0 && g_a.queued && g_b.queued && g_c.queued);
+    CHECK(g_a.due_next == &g_b && g_b.due_next == &g_c && g_c.due_next == NULL);
+
+    // Out of the middle, then off the tail: later appends still link up
+    CHECK(timer_stop(&g_b) == KERNEL_OK);
+    CHECK(!g_b.queued && g_a.due_next == &g_c && g_c.due_pprev == &g_a.due_next);
+    CHECK(timer_stop(&g_c) == KERNEL_OK);
+    CHECK(!g_c.queued && g_a.due_next == NULL);
+    CHECK(timer_start(&g_d, 1, 0) == KERNEL_OK);
+    host_tick();
+    CHECK(g_a.due_next == &g_d && g_d.due_pprev == &g_a.due_next);
+
+    // A restart while queued drops the queued expiry for the new one
+    CHECK(timer_start(&g_b, 1, 0) == KERNEL_OK);
+    host_tick();
+    CHECK(g_b.queued && g_d.due_next == &g_b);
+    start = kernel_get_tick();
+    CHECK(timer_start(&g_b, 5, 0) == KERNEL_OK);
+    CHECK(!g_b.queued && g_b.active && g_d.due_next == NULL);
+
+    host_run(10);
+    g_order[g_ran] = '\0';
+    CHECK(strcmp(g_order, "adb") == 0);
+    CHECK(strcmp(g_ctx, "timer") == 0);
+    CHECK(g_b_tick == start + 5U);
+
+    // Periodic every 2 ticks, each callback blocking for 3
+    CHECK(timer_start(&g_slow, 2, 1) == KERNEL_OK);
+    host_run(40);
+    CHECK(g_slow_runs >= 10 && g_slow_runs <= 14);
+    CHECK(timer_stop(&g_slow) == KERNEL_OK);
+
+    printf("test_timer_daemon: ok (%d slow callbacks for 20 expiries)\n", g_slow_runs);
+    return 0;
+}
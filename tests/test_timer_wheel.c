@@ -0,0 +1,131 @@
+// HelixRT - Timer wheel against a reference model
+//
+// 600 timers, 3M ticks of random starts and stops across every wheel
+// level, with callbacks that stop other timers. Every firing must land
+// on its exact tick, and timer_next_expiry() must never overshoot the
+// model. A final phase skips ticks with timer_advance() as tickless
+// idle does.
+
+
+#include "host/common.h"
+
+#define NTIMERS         600
+#define STEPS           3000000L
+#define SKIPS           20000
+
+static sw_timer_t g_tm[NTIMERS];
+static uint32_t g_due[NTIMERS], g_period[NTIMERS];
+static int g_active[NTIMERS], g_periodic[NTIMERS];
+static uint32_t g_now;
+static long g_fired;
+
+static void cb(void *arg)
+{
+    int i = (int)(intptr_t)arg;
+    int j;
+
+    CHECK(g_active[i] && g_due[i] == g_now);
+    g_fired++;
+    if (g_periodic[i]) {
+        g_due[i] += g_period[i];
+    } else {
+        g_active[i] = 0;
+    }
+
+    // Callbacks sometimes stop other timers
+    j = rand() % NTIMERS;
+    if (rand() % 4 == 0) {
+        (void)timer_stop(&g_tm[j]);
+        g_active[j] = 0;
+    }
+}
+
+// Spread over level 0, the upper levels and past the wheel's span
+static uint32_t random_period(void)
+{
+    switch (rand() % 5) {
+    case 0:
+        return 1U + (uint32_t)(rand() % 63);
+    case 1:
+        return 64U + (uint32_t)(rand() % 4000);
+    case 2:
+        return 1U + (uint32_t)(rand() % 300000);
+    case 3:
+        return 64U;
+    default:
+        return 1U + (uint32_t)(rand() % 20000000);
+    }
+}
+
+// Ticks to the earliest modelled expiry
+static uint32_t model_next(void)
+{
+    uint32_t best = UINT32_MAX;
+    int i;
+
+    for (i = 0; i < NTIMERS; i++) {
+        if (g_active[i] && g_due[i] - g_now < best) {
+            best = g_due[i] - g_now;
+        }
+    }
+    return best;
+}
+
+int main(void)
+{
+    uint32_t p, e;
+    long step;
+    int i, k, op, periodic;
+
+    srand(1);
+    for (i = 0; i < NTIMERS; i++) {
+        CHECK(timer_create(&g_tm[i], cb, (void *)(intptr_t)i) == KERNEL_OK);
+    }
+
+    for (step = 0; step < STEPS; step++) {
+        op = rand() % 100;
+        if (op < 3) {
+            i = rand() % NTIMERS;
+            p = random_period();
+            periodic = rand() % 2;
+            if (p > 5000000U && periodic) {
+                p = p % 5000U + 1U;
+            }
+            CHECK(timer_start(&g_tm[i], p, periodic) == KERNEL_OK);
+            g_active[i] = 1;
+            g_due[i] = g_now + p;
+            g_period[i] = p;
+            g_periodic[i] = periodic;
+        } else if (op < 4) {
+            i = rand() % NTIMERS;
+            (void)timer_stop(&g_tm[i]);
+            g_active[i] = 0;
+        }
+
+        g_now++;
+        timer_tick_isr();
+        for (k = 0; k < 3; k++) {
+            i = rand() % NTIMERS;
+            CHECK(timer_is_active(&g_tm[i]) == g_active[i]);
+        }
+        if (step % 100000 == 0) {
+            CHECK(timer_next_expiry() <= model_next());
+        }
+    }
+
+    // Skip ahead as far as timer_next_expiry() allows
+    for (k = 0; k < SKIPS; k++) {
+        e = timer_next_expiry();
+        CHECK(e <= model_next());
+        if (e > 1U && e != UINT32_MAX) {
+            timer_advance(e - 1U);
+            g_now += e - 1U;
+        }
+        g_now++;
+        timer_tick_isr();
+    }
+    CHECK(g_fired > 0);
+
+    printf("test_timer_wheel: ok\n");
+    return 0;
+}
@@ -0,0 +1,72 @@
+// HelixRT - Periodic release timing
+//
+// task_wait_next_period() releases jobs on the period grid. A tick
+// that lands between the deadline check and the block must not leave
+// the task waiting forever, and an overrunning job is released again
+// at once, on the grid it missed.
+
+
+#include "host/uctx.h"
+
+#define PERIOD          5U
+
+static uint32_t g_release[16];
+static int g_jobs = 0;
+static int g_inject = 0;
+
+// Takes one tick at the next critical-section exit inside a task
+static void inject_hook(void)
+{
+    if (g_inject && host_in_task >= 0) {
+        g_inject = 0;
+        host_tick();
+        host_now++;
+    }
+    host_hook();
+}
+
+static void job(void *arg)
+{
+    (void)arg;
+    g_release[g_jobs++] = kernel_get_tick();
+    host_switch_hook = inject_hook;
+
+    if (g_jobs == 2) {
+        // Runs to one tick short of the release; the last lands in the wait
+        host_work(PERIOD - 1U);
+        g_inject = 1;
+    } else if (g_jobs == 4) {
+        // Overruns the next release by one tick
+        host_work(PERIOD + 1U);
+    }
+}
+
+// Job loop run directly by the host, in place of the kernel's own
+static void periodic(void *arg)
+{
+    for (;;) {
+        job(arg);
+        (void)task_wait_next_period();
+    }
+}
+
+int main(void)
+{
+    static const uint32_t expect[] = { 0, 5, 10, 15, 21, 25, 30 };
+    task_tcb_t *t = &tcbs[0];
+    uint32_t i;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(task_create_periodic(t, "periodic", job, NULL, 2, stacks[0],
+                               sizeof(stacks[0]), PERIOD, 0, 1) == KERNEL_OK);
+    t->entry = periodic;
+
+    host_run(40);
+    CHECK(g_jobs >= 7);
+    for (i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        CHECK(g_release[i] == expect[i]);
+    }
+
+    printf("test_wait_period: ok\n");
+    return 0;
+}
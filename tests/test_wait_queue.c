@@ -0,0 +1,60 @@
+// HelixRT - Object wait queues
+//
+// Waiters queue on the object in priority order, FIFO within a
+// priority; a priority change re-sorts the waiter in place; deleting a
+// blocked task unlinks it; wakeups take the head.
+
+
+#include "host/common.h"
+
+static void block_on(task_tcb_t *tcb, semaphore_t *sem)
+{
+    (void)host_block(tcb, BLOCK_SEMAPHORE, sem, &sem->wait_list_head,
+                     &sem->wait_list_tail, TIMEOUT_FOREVER);
+    CHECK(tcb->state == TASK_STATE_BLOCKED);
+}
+
+int main(void)
+{
+    semaphore_t sem;
+    task_tcb_t *a, *b, *c, *d;
+
+    CHECK(kernel_init() == KERNEL_OK);
+    CHECK(sem_init(&sem, 0, 0) == KERNEL_OK);
+    a = mk(0, 5);
+    b = mk(1, 3);
+    c = mk(2, 5);
+    d = mk(3, 7);
+
+    // Arrival order b, a, c, d; queue order by priority, FIFO for a/c
+    block_on(b, &sem);
+    block_on(a, &sem);
+    block_on(c, &sem);
+    block_on(d, &sem);
+    CHECK(sem.wait_list_head == b && b->wait_next == a && a->wait_next == c &&
+          c->wait_next == d && d->wait_next == NULL);
+    CHECK(sem.wait_list_tail == d && d->wait_prev == c);
+
+    // A boosted waiter moves to the front
+    scheduler_set_priority(d, 1);
+    CHECK(sem.wait_list_head == d && sem.wait_list_tail == c);
+
+    // A give wakes the head
+    CHECK(sem_give(&sem) == KERNEL_OK);
+    CHECK(d->state == TASK_STATE_READY && sem.wait_list_head == b);
+
+    // A deleted waiter is unlinked
+    CHECK(task_delete(c) == KERNEL_OK);
+    CHECK(sem.wait_list_head == b && b->wait_next == a && a->wait_next == NULL &&
+          sem.wait_list_tail == a);
+
+    CHECK(scheduler_unblock_all(&sem.wait_list_head, KERNEL_OK) == 2U);
+    CHECK(sem.wait_list_head == NULL && sem.wait_list_tail == NULL);
+    CHECK(a->state == TASK_STATE_READY && b->state == TASK_STATE_READY);
+
+    // The unit given to d stays counted until d runs and takes it
+    CHECK(sem.count == 1 && sem_give(&sem) == KERNEL_OK && sem.count == 2);
+
+    printf("test_wait_queue: ok\n");
+    return 0;
+}